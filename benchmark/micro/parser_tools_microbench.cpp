@@ -0,0 +1,245 @@
+// Standalone microbenchmarks of the parser_tools functions, reporting rows/s and bytes/s.
+//
+// The corpora are the ones of the interpreted benchmarks (benchmark/parser_tools/<corpus>.benchmark.in, whose load
+// block creates a `corpus` table of queries), as are the measured expressions
+// (benchmark/parser_tools/<corpus>/*.benchmark).
+// Two levels are measured per corpus:
+// - sql: each function end to end, as `SELECT <expression> FROM corpus`
+// - walk: the extractors alone over the statements of the distinct queries, parsed once up front
+//
+// Built with make bench, and run from the root of the repository: parser_tools_microbench [corpus or function filter]
+
+#include "duckdb.hpp"
+#include "parser_tools_extension.hpp"
+#include "parse_tables.hpp"
+#include "parse_functions.hpp"
+#include "parse_where.hpp"
+#include "parse_columns.hpp"
+#include "parse_joins.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/parser/parser.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+
+using namespace duckdb;
+
+static constexpr const char *BENCHMARK_DIRECTORY = "benchmark/parser_tools";
+static constexpr const char *CORPORA[] = {"tpch", "tpcds", "query_log", "nested_predicate", "script"};
+static constexpr idx_t RUNS = 5;
+
+struct Corpus {
+	string name;
+	vector<string> required_extensions;
+	// the statements of the load block
+	string load;
+	// function name -> measured expression
+	vector<std::pair<string, string>> expressions;
+};
+
+static string ReadFile(FileSystem &fs, const string &path) {
+	auto handle = fs.OpenFile(path, FileFlags::FILE_FLAGS_READ);
+	string contents(NumericCast<idx_t>(handle->GetFileSize()), '\0');
+	handle->Read((void *)contents.data(), contents.size(), 0);
+	return contents;
+}
+
+// The require lines and the load block of a benchmark template
+static bool ReadCorpus(FileSystem &fs, const string &name, Corpus &corpus) {
+	auto path = fs.JoinPath(BENCHMARK_DIRECTORY, name + ".benchmark.in");
+	if (!fs.FileExists(path)) {
+		return false;
+	}
+	corpus.name = name;
+	bool in_load = false;
+	for (auto &line : StringUtil::Split(ReadFile(fs, path), '\n')) {
+		auto trimmed = line;
+		StringUtil::Trim(trimmed);
+		if (in_load) {
+			if (trimmed.empty()) {
+				in_load = false;
+			} else {
+				corpus.load += line + "\n";
+			}
+		} else if (trimmed == "load") {
+			in_load = true;
+		} else if (StringUtil::StartsWith(trimmed, "require ")) {
+			corpus.required_extensions.push_back(trimmed.substr(8));
+		}
+	}
+
+	vector<string> files;
+	fs.ListFiles(fs.JoinPath(BENCHMARK_DIRECTORY, name), [&](const string &file, bool is_directory) {
+		if (!is_directory && StringUtil::EndsWith(file, ".benchmark")) {
+			files.push_back(fs.JoinPath(fs.JoinPath(BENCHMARK_DIRECTORY, name), file));
+		}
+	});
+	std::sort(files.begin(), files.end());
+	for (auto &file : files) {
+		string function, expression;
+		for (auto &line : StringUtil::Split(ReadFile(fs, file), '\n')) {
+			if (StringUtil::StartsWith(line, "FUNCTION=")) {
+				function = line.substr(9);
+			} else if (StringUtil::StartsWith(line, "EXPRESSION=")) {
+				expression = line.substr(11);
+			}
+		}
+		if (!function.empty() && !expression.empty()) {
+			corpus.expressions.emplace_back(function, expression);
+		}
+	}
+	return true;
+}
+
+// The median of RUNS timed runs after a warm-up run, in seconds
+static double Measure(const std::function<void()> &run) {
+	run();
+	vector<double> timings;
+	for (idx_t i = 0; i < RUNS; i++) {
+		auto start = std::chrono::steady_clock::now();
+		run();
+		timings.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+	}
+	std::sort(timings.begin(), timings.end());
+	return timings[RUNS / 2];
+}
+
+static void Report(const string &corpus, const string &level, const string &function, double seconds, idx_t rows,
+                   idx_t bytes) {
+	printf("%-18s %-6s %-22s %10.2f ms %14.0f rows/s %10.1f MB/s\n", corpus.c_str(), level.c_str(), function.c_str(),
+	       seconds * 1000, double(rows) / seconds, double(bytes) / seconds / 1e6);
+	fflush(stdout);
+}
+
+static bool Matches(const string &filter, const string &corpus, const string &function) {
+	return filter.empty() || corpus.find(filter) != string::npos || function.find(filter) != string::npos;
+}
+
+template <class RESULT>
+using Extractor = std::function<void(const vector<unique_ptr<SQLStatement>> &, vector<RESULT> &)>;
+
+// Times an extractor over the statements of every query
+template <class RESULT>
+static void MeasureWalk(const string &corpus, const string &function,
+                        const vector<vector<unique_ptr<SQLStatement>>> &parsed, idx_t bytes,
+                        const Extractor<RESULT> &extract) {
+	vector<RESULT> results;
+	auto seconds = Measure([&]() {
+		for (auto &statements : parsed) {
+			results.clear();
+			extract(statements, results);
+		}
+	});
+	Report(corpus, "walk", function, seconds, parsed.size(), bytes);
+}
+
+static void RunCorpus(const Corpus &corpus, const string &filter) {
+	DuckDB db(nullptr);
+	db.LoadStaticExtension<ParserToolsExtension>();
+	Connection con(db);
+	for (auto &extension : corpus.required_extensions) {
+		if (extension == "parser_tools") {
+			continue;
+		}
+		auto result = con.Query("LOAD " + extension);
+		if (result->HasError()) {
+			printf("%-18s skipped: the %s extension is not available\n", corpus.name.c_str(), extension.c_str());
+			return;
+		}
+	}
+	auto load = con.Query(corpus.load);
+	if (load->HasError()) {
+		printf("%-18s skipped: %s\n", corpus.name.c_str(), load->GetError().c_str());
+		return;
+	}
+	auto size = con.Query("SELECT count(*), sum(strlen(sql)) FROM corpus");
+	auto rows = size->GetValue(0, 0).GetValue<idx_t>();
+	auto bytes = size->GetValue(1, 0).GetValue<idx_t>();
+
+	for (auto &entry : corpus.expressions) {
+		if (!Matches(filter, corpus.name, entry.first)) {
+			continue;
+		}
+		auto query = "SELECT " + entry.second + " FROM corpus";
+		string error;
+		auto seconds = Measure([&]() {
+			auto result = con.Query(query);
+			if (result->HasError()) {
+				error = result->GetError();
+			}
+		});
+		if (!error.empty()) {
+			printf("%-18s %-6s %-22s failed: %s\n", corpus.name.c_str(), "sql", entry.first.c_str(), error.c_str());
+			continue;
+		}
+		Report(corpus.name, "sql", entry.first, seconds, rows, bytes);
+	}
+
+	// the extractors alone, over the distinct queries
+	auto distinct = con.Query("SELECT DISTINCT sql FROM corpus");
+	vector<vector<unique_ptr<SQLStatement>>> parsed;
+	idx_t distinct_bytes = 0;
+	Parser parser;
+	for (idx_t i = 0; i < distinct->RowCount(); i++) {
+		auto sql = distinct->GetValue(0, i).ToString();
+		try {
+			parser.ParseQuery(sql);
+		} catch (const std::exception &) {
+			continue;
+		}
+		distinct_bytes += sql.size();
+		parsed.push_back(std::move(parser.statements));
+		parser.statements.clear();
+	}
+	if (Matches(filter, corpus.name, "ExtractTablesFromStatements")) {
+		MeasureWalk<TableRefResult>(
+		    corpus.name, "tables", parsed, distinct_bytes,
+		    [](const vector<unique_ptr<SQLStatement>> &statements, vector<TableRefResult> &results) {
+			    ExtractTablesFromStatements(statements, results);
+		    });
+	}
+	if (Matches(filter, corpus.name, "ExtractFunctionsFromStatements")) {
+		MeasureWalk<FunctionResult>(
+		    corpus.name, "functions", parsed, distinct_bytes,
+		    [](const vector<unique_ptr<SQLStatement>> &statements, vector<FunctionResult> &results) {
+			    ExtractFunctionsFromStatements(statements, results);
+		    });
+	}
+	if (Matches(filter, corpus.name, "ExtractWhereConditionsFromStatements")) {
+		MeasureWalk<WhereConditionResult>(
+		    corpus.name, "where", parsed, distinct_bytes,
+		    [](const vector<unique_ptr<SQLStatement>> &statements, vector<WhereConditionResult> &results) {
+			    ExtractWhereConditionsFromStatements(statements, results);
+		    });
+	}
+	if (Matches(filter, corpus.name, "ExtractColumnsFromStatements")) {
+		MeasureWalk<ColumnResult>(
+		    corpus.name, "columns", parsed, distinct_bytes,
+		    [](const vector<unique_ptr<SQLStatement>> &statements, vector<ColumnResult> &results) {
+			    ExtractColumnsFromStatements(statements, results);
+		    });
+	}
+	if (Matches(filter, corpus.name, "ExtractJoinsFromStatements")) {
+		MeasureWalk<JoinResult>(corpus.name, "joins", parsed, distinct_bytes,
+		                        [](const vector<unique_ptr<SQLStatement>> &statements, vector<JoinResult> &results) {
+			                        ExtractJoinsFromStatements(statements, results);
+		                        });
+	}
+}
+
+int main(int argc, char **argv) {
+	string filter = argc > 1 ? argv[1] : "";
+	auto fs = FileSystem::CreateLocal();
+	for (auto name : CORPORA) {
+		Corpus corpus;
+		if (!ReadCorpus(*fs, name, corpus)) {
+			fprintf(stderr, "%s/%s.benchmark.in not found: run from the root of the repository\n", BENCHMARK_DIRECTORY,
+			        name);
+			return 1;
+		}
+		RunCorpus(corpus, filter);
+	}
+	return 0;
+}
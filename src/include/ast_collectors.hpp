@@ -0,0 +1,142 @@
+#pragma once
+
+#include "ast_walker.hpp"
+#include "parse_cache.hpp"
+#include "parse_tables.hpp"
+#include "parse_functions.hpp"
+#include "parse_where.hpp"
+#include "parse_columns.hpp"
+#include "parse_joins.hpp"
+
+namespace duckdb {
+
+// The collectors behind the parse_tables, parse_functions and parse_where extractors.
+// They can be combined in a single walk: WalkStatements(statements, tables, functions, conditions)
+
+struct TableCollector : public ASTCollector {
+	static constexpr bool VISIT_TABLE_REFS = true;
+
+	explicit TableCollector(std::vector<TableRefResult> &results_p, table_context_mask_t contexts_p = ALL_TABLE_CONTEXTS)
+	    : results(results_p), contexts(contexts_p) {
+	}
+
+	bool WantsTableRefs() const {
+		// only CTE definitions are reported without walking the FROM clauses
+		return (contexts & ~TableContextBit(TableContext::CTE)) != 0;
+	}
+
+	void VisitCTE(const string &name, const ASTWalkState &state) {
+		if (!(contexts & TableContextBit(TableContext::CTE))) {
+			return;
+		}
+		results.push_back(TableRefResult {string_t("", 0), string_t(name.c_str(), UnsafeNumericCast<uint32_t>(name.size())),
+		                                  TableContext::CTE});
+	}
+
+	void VisitBaseTable(const BaseTableRef &ref, TableContext context, const ASTWalkState &state) {
+		if (!(contexts & TableContextBit(context))) {
+			return;
+		}
+		auto &schema = ref.schema_name;
+		auto &table = ref.table_name;
+		results.push_back(TableRefResult {
+		    schema.empty() ? string_t(DEFAULT_SCHEMA_NAME) : string_t(schema.c_str(), UnsafeNumericCast<uint32_t>(schema.size())),
+		    string_t(table.c_str(), UnsafeNumericCast<uint32_t>(table.size())), context});
+	}
+
+	std::vector<TableRefResult> &results;
+	// the contexts to report, filtered before any result is created
+	table_context_mask_t contexts;
+};
+
+struct FunctionCollector : public ASTCollector {
+	static constexpr bool VISIT_EXPRESSIONS = true;
+
+	explicit FunctionCollector(std::vector<FunctionResult> &results_p) : results(results_p) {
+	}
+
+	void VisitFunction(const ParsedExpression &expr, const string &function_name, const string &schema,
+	                   FunctionContext context, const ASTWalkState &state) {
+		if (state.from_subquery) {
+			// functions of subqueries in the FROM clause are not reported
+			return;
+		}
+		results.push_back(FunctionResult {
+		    string_t(function_name.c_str(), UnsafeNumericCast<uint32_t>(function_name.size())),
+		    schema.empty() ? string_t(DEFAULT_SCHEMA_NAME) : string_t(schema.c_str(), UnsafeNumericCast<uint32_t>(schema.size())),
+		    context});
+	}
+
+	std::vector<FunctionResult> &results;
+};
+
+// Reports every column reference with its clause, including those of JOIN conditions and FROM subqueries
+struct ColumnCollector : public ASTCollector {
+	static constexpr bool VISIT_TABLE_REFS = true;
+	static constexpr bool VISIT_EXPRESSIONS = true;
+	static constexpr bool VISIT_SUBQUERY_EXPRESSIONS = true;
+	static constexpr bool VISIT_JOIN_CONDITIONS = true;
+
+	explicit ColumnCollector(std::vector<ColumnResult> &results_p) : results(results_p) {
+	}
+
+	void VisitColumnRef(const ColumnRefExpression &expr, const ASTWalkState &state) {
+		auto &names = expr.column_names;
+		if (names.empty()) {
+			return;
+		}
+		auto &column = names.back();
+		string_t table("", 0);
+		if (names.size() >= 2) {
+			auto &qualifier = names[names.size() - 2];
+			table = string_t(qualifier.c_str(), UnsafeNumericCast<uint32_t>(qualifier.size()));
+		} else if (state.select_node && state.select_node->from_table &&
+		           state.select_node->from_table->type != TableReferenceType::JOIN) {
+			// the single source of the FROM clause: its alias, or the name of a base table
+			auto &source = *state.select_node->from_table;
+			auto &name = source.alias.empty() && source.type == TableReferenceType::BASE_TABLE
+			                 ? ((BaseTableRef &)source).table_name
+			                 : source.alias;
+			table = string_t(name.c_str(), UnsafeNumericCast<uint32_t>(name.size()));
+		}
+		results.push_back(
+		    ColumnResult {table, string_t(column.c_str(), UnsafeNumericCast<uint32_t>(column.size())), state.clause});
+	}
+
+	std::vector<ColumnResult> &results;
+};
+
+// Reports the edges of every join of the FROM clauses, including those of CTEs and subqueries
+struct JoinCollector : public ASTCollector {
+	static constexpr bool VISIT_TABLE_REFS = true;
+
+	explicit JoinCollector(std::vector<JoinResult> &results_p) : results(results_p) {
+	}
+
+	void VisitJoin(const JoinRef &ref, const ASTWalkState &state) {
+		ExtractJoinEdges(ref, results);
+	}
+
+	std::vector<JoinResult> &results;
+};
+
+// Flattens the conjunctions of a WHERE or HAVING clause of `node` into conditions (defined in parse_where.cpp)
+void ExtractWhereConditions(const ParsedExpression &expr, FunctionContext clause, const SelectNode &node,
+                            vector<WhereConditionResult> &results);
+
+// Reports the WHERE and HAVING conditions of the root select node of each statement
+struct WhereCollector : public ASTCollector {
+	explicit WhereCollector(vector<WhereConditionResult> &results_p) : results(results_p) {
+	}
+
+	void VisitClause(const ParsedExpression &expr, FunctionContext clause, const SelectNode &node,
+	                 const ASTWalkState &state) {
+		if (state.statement_root && (clause == FunctionContext::Where || clause == FunctionContext::Having)) {
+			ExtractWhereConditions(expr, clause, node, results);
+		}
+	}
+
+	vector<WhereConditionResult> &results;
+};
+
+} // namespace duckdb
@@ -0,0 +1,505 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "parse_tables.hpp"
+#include "parse_functions.hpp"
+#include "duckdb/parser/statement/select_statement.hpp"
+#include "duckdb/parser/query_node/select_node.hpp"
+#include "duckdb/parser/query_node/cte_node.hpp"
+#include "duckdb/parser/tableref/basetableref.hpp"
+#include "duckdb/parser/tableref/joinref.hpp"
+#include "duckdb/parser/tableref/subqueryref.hpp"
+#include "duckdb/parser/expression/columnref_expression.hpp"
+#include "duckdb/parser/expression/function_expression.hpp"
+#include "duckdb/parser/expression/window_expression.hpp"
+#include "duckdb/parser/parsed_expression_iterator.hpp"
+#include "duckdb/parser/result_modifier.hpp"
+#include <algorithm>
+
+namespace duckdb {
+
+// A single traversal of the parsed statements shared by all extractors.
+// The walker visits every SELECT statement once and reports what it finds to a set of collectors that is fixed at
+// compile time: WalkStatements(statements, tables, functions) fills both collectors from the same traversal,
+// and each hook is a direct (inlinable) call on the concrete collector type.
+//
+// Collectors derive from ASTCollector and hide the hooks they are interested in. The VISIT_* flags tell the walker
+// which parts of the tree any collector needs, so that e.g. a function-only walk never descends into FROM clauses.
+// A collector that only looks for the first match (references_table) ends the walk early through IsDone, and a
+// step budget (SetStepBudget) bounds the work of a walk whatever the collectors.
+
+struct ASTWalkState {
+	// true for the root query node of a statement (not for CTE_NODE children, CTE bodies or subqueries)
+	bool statement_root = false;
+	// true below a subquery of a FROM clause
+	bool from_subquery = false;
+	// the innermost select node and, within its expressions, the clause they belong to (Join for JOIN ... ON
+	// conditions, WindowFunction for the PARTITION BY and ORDER BY of a window)
+	const SelectNode *select_node = nullptr;
+	FunctionContext clause = FunctionContext::Select;
+};
+
+struct ASTCollector {
+	// descend into FROM clauses: table refs, joins and their subqueries
+	static constexpr bool VISIT_TABLE_REFS = false;
+	// descend into the expressions of the select, where, group by, having and order by clauses
+	static constexpr bool VISIT_EXPRESSIONS = false;
+	// also descend into the expressions of subqueries in FROM clauses (requires VISIT_TABLE_REFS in some collector)
+	static constexpr bool VISIT_SUBQUERY_EXPRESSIONS = false;
+	// descend into the JOIN ... ON conditions of FROM clauses, with the Join context (requires VISIT_TABLE_REFS)
+	static constexpr bool VISIT_JOIN_CONDITIONS = false;
+
+	// runtime refinement of VISIT_TABLE_REFS: return false if this walk has no use for the FROM clauses
+	bool WantsTableRefs() const {
+		return true;
+	}
+	// return true once this collector has seen all it needs; the walk stops when every collector is done
+	bool IsDone() const {
+		return false;
+	}
+
+	// a CTE defined by a select node, visited before its body
+	void VisitCTE(const string &name, const ASTWalkState &state) {
+	}
+	// a base table of a FROM clause, with its position in the query
+	void VisitBaseTable(const BaseTableRef &ref, TableContext context, const ASTWalkState &state) {
+	}
+	// a join of a FROM clause, visited before its sides
+	void VisitJoin(const JoinRef &ref, const ASTWalkState &state) {
+	}
+	// the root expression of a clause; Select, Where, GroupBy, Having and OrderBy are reported
+	void VisitClause(const ParsedExpression &expr, FunctionContext clause, const SelectNode &node,
+	                 const ASTWalkState &state) {
+	}
+	// a function or window function call, with the context it appears in
+	void VisitFunction(const ParsedExpression &expr, const string &function_name, const string &schema,
+	                   FunctionContext context, const ASTWalkState &state) {
+	}
+	// a column reference, in the clause of state
+	void VisitColumnRef(const ColumnRefExpression &expr, const ASTWalkState &state) {
+	}
+};
+
+// Compile-time pack of collectors, forwarding every hook to each of them in order
+template <class... COLLECTORS>
+struct ASTCollectorSet;
+
+template <>
+struct ASTCollectorSet<> {
+	static constexpr bool VISIT_TABLE_REFS = false;
+	static constexpr bool VISIT_EXPRESSIONS = false;
+	static constexpr bool VISIT_SUBQUERY_EXPRESSIONS = false;
+	static constexpr bool VISIT_JOIN_CONDITIONS = false;
+
+	bool WantsTableRefs() const {
+		return false;
+	}
+	bool IsDone() const {
+		return true;
+	}
+	void VisitCTE(const string &, const ASTWalkState &) {
+	}
+	void VisitBaseTable(const BaseTableRef &, TableContext, const ASTWalkState &) {
+	}
+	void VisitJoin(const JoinRef &, const ASTWalkState &) {
+	}
+	void VisitClause(const ParsedExpression &, FunctionContext, const SelectNode &, const ASTWalkState &) {
+	}
+	void VisitFunction(const ParsedExpression &, const string &, const string &, FunctionContext,
+	                   const ASTWalkState &) {
+	}
+	void VisitColumnRef(const ColumnRefExpression &, const ASTWalkState &) {
+	}
+};
+
+template <class HEAD, class... TAIL>
+struct ASTCollectorSet<HEAD, TAIL...> {
+	static constexpr bool VISIT_TABLE_REFS = HEAD::VISIT_TABLE_REFS || ASTCollectorSet<TAIL...>::VISIT_TABLE_REFS;
+	static constexpr bool VISIT_EXPRESSIONS = HEAD::VISIT_EXPRESSIONS || ASTCollectorSet<TAIL...>::VISIT_EXPRESSIONS;
+	static constexpr bool VISIT_SUBQUERY_EXPRESSIONS =
+	    HEAD::VISIT_SUBQUERY_EXPRESSIONS || ASTCollectorSet<TAIL...>::VISIT_SUBQUERY_EXPRESSIONS;
+	static constexpr bool VISIT_JOIN_CONDITIONS =
+	    HEAD::VISIT_JOIN_CONDITIONS || ASTCollectorSet<TAIL...>::VISIT_JOIN_CONDITIONS;
+
+	explicit ASTCollectorSet(HEAD &head_p, TAIL &... tail_p) : head(head_p), tail(tail_p...) {
+	}
+
+	bool WantsTableRefs() const {
+		return (HEAD::VISIT_TABLE_REFS && head.WantsTableRefs()) || tail.WantsTableRefs();
+	}
+	bool IsDone() const {
+		return head.IsDone() && tail.IsDone();
+	}
+	void VisitCTE(const string &name, const ASTWalkState &state) {
+		head.VisitCTE(name, state);
+		tail.VisitCTE(name, state);
+	}
+	void VisitBaseTable(const BaseTableRef &ref, TableContext context, const ASTWalkState &state) {
+		head.VisitBaseTable(ref, context, state);
+		tail.VisitBaseTable(ref, context, state);
+	}
+	void VisitJoin(const JoinRef &ref, const ASTWalkState &state) {
+		head.VisitJoin(ref, state);
+		tail.VisitJoin(ref, state);
+	}
+	void VisitClause(const ParsedExpression &expr, FunctionContext clause, const SelectNode &node,
+	                 const ASTWalkState &state) {
+		head.VisitClause(expr, clause, node, state);
+		tail.VisitClause(expr, clause, node, state);
+	}
+	void VisitFunction(const ParsedExpression &expr, const string &function_name, const string &schema,
+	                   FunctionContext context, const ASTWalkState &state) {
+		head.VisitFunction(expr, function_name, schema, context, state);
+		tail.VisitFunction(expr, function_name, schema, context, state);
+	}
+	void VisitColumnRef(const ColumnRefExpression &expr, const ASTWalkState &state) {
+		head.VisitColumnRef(expr, state);
+		tail.VisitColumnRef(expr, state);
+	}
+
+	HEAD &head;
+	ASTCollectorSet<TAIL...> tail;
+};
+
+// A pending step of the walk. Instead of recursing once per node, the walker keeps these on an explicit stack, so
+// that its C++ stack usage does not grow with the depth of the query (nested CASE expressions, long conjunction
+// chains, stacked subqueries)
+struct ASTWalkStep {
+	enum class Kind : uint8_t { QUERY_NODE, TABLE_REF, CTE, CLAUSE, EXPRESSION };
+
+	Kind kind = Kind::QUERY_NODE;
+	ASTWalkState state;
+	// QUERY_NODE and TABLE_REF: the position in the query and the CTEs in scope
+	TableContext table_context = TableContext::From;
+	bool is_top_level = false;
+	const CommonTableExpressionMap *cte_map = nullptr;
+	// CLAUSE and EXPRESSION: the clause or function context
+	FunctionContext function_context = FunctionContext::Select;
+	const SelectNode *select_node = nullptr;
+
+	const QueryNode *node = nullptr;
+	const TableRef *ref = nullptr;
+	const string *cte_name = nullptr;
+	const ParsedExpression *expr = nullptr;
+};
+
+template <class... COLLECTORS>
+class ASTWalker {
+public:
+	using collector_set_t = ASTCollectorSet<COLLECTORS...>;
+
+	explicit ASTWalker(COLLECTORS &... collectors_p)
+	    : collectors(collectors_p...), visit_table_refs(collector_set_t::VISIT_TABLE_REFS && collectors.WantsTableRefs()) {
+	}
+
+	void WalkStatements(const vector<unique_ptr<SQLStatement>> &statements) {
+		for (auto &stmt : statements) {
+			if (collectors.IsDone() || budget_exhausted) {
+				return;
+			}
+			if (stmt) {
+				WalkStatement(*stmt);
+			}
+		}
+	}
+
+	void WalkStatement(const SQLStatement &stmt) {
+		if (stmt.type != StatementType::SELECT_STATEMENT) {
+			return;
+		}
+		auto &select_stmt = (SelectStatement &)stmt;
+		if (select_stmt.node) {
+			ASTWalkState state;
+			state.statement_root = true;
+			PushQueryNode(*select_stmt.node, state, TableContext::From, nullptr);
+			Run();
+		}
+	}
+
+	// Stops the walk after `max_steps` steps (0: unlimited); BudgetExhausted then reports that it did
+	void SetStepBudget(idx_t max_steps_p) {
+		max_steps = max_steps_p;
+	}
+	bool BudgetExhausted() const {
+		return budget_exhausted;
+	}
+
+private:
+	// Steps are visited in pre-order: the children of a step are pushed in the order they are to be walked and then
+	// reversed, so that they are popped in that order, each after all steps its predecessor pushed in turn
+	void Run() {
+		while (!stack.empty()) {
+			if (collectors.IsDone()) {
+				stack.clear();
+				return;
+			}
+			if (max_steps > 0 && ++steps > max_steps) {
+				budget_exhausted = true;
+				stack.clear();
+				return;
+			}
+			auto step = stack.back();
+			stack.pop_back();
+			auto mark = stack.size();
+			switch (step.kind) {
+			case ASTWalkStep::Kind::QUERY_NODE:
+				WalkQueryNode(*step.node, step.state, step.table_context, step.cte_map);
+				break;
+			case ASTWalkStep::Kind::TABLE_REF:
+				WalkTableRef(*step.ref, step.state, step.table_context, step.is_top_level, step.cte_map);
+				break;
+			case ASTWalkStep::Kind::CTE:
+				collectors.VisitCTE(*step.cte_name, step.state);
+				break;
+			case ASTWalkStep::Kind::CLAUSE:
+				WalkClause(*step.expr, step.function_context, *step.select_node, step.state);
+				break;
+			case ASTWalkStep::Kind::EXPRESSION:
+				WalkExpression(*step.expr, step.function_context, step.state);
+				break;
+			}
+			std::reverse(stack.begin() + NumericCast<int64_t>(mark), stack.end());
+		}
+	}
+
+	void PushQueryNode(const QueryNode &node, const ASTWalkState &state, TableContext context,
+	                   const CommonTableExpressionMap *cte_map) {
+		ASTWalkStep step;
+		step.kind = ASTWalkStep::Kind::QUERY_NODE;
+		step.state = state;
+		step.table_context = context;
+		step.cte_map = cte_map;
+		step.node = &node;
+		stack.push_back(step);
+	}
+
+	void PushTableRef(const TableRef &ref, const ASTWalkState &state, TableContext context, bool is_top_level,
+	                  const CommonTableExpressionMap *cte_map) {
+		ASTWalkStep step;
+		step.kind = ASTWalkStep::Kind::TABLE_REF;
+		step.state = state;
+		step.table_context = context;
+		step.is_top_level = is_top_level;
+		step.cte_map = cte_map;
+		step.ref = &ref;
+		stack.push_back(step);
+	}
+
+	void PushCTE(const string &name, const ASTWalkState &state) {
+		ASTWalkStep step;
+		step.kind = ASTWalkStep::Kind::CTE;
+		step.state = state;
+		step.cte_name = &name;
+		stack.push_back(step);
+	}
+
+	void PushClause(const ParsedExpression &expr, FunctionContext clause, const SelectNode &node,
+	                const ASTWalkState &state) {
+		ASTWalkStep step;
+		step.kind = ASTWalkStep::Kind::CLAUSE;
+		step.state = state;
+		step.function_context = clause;
+		step.select_node = &node;
+		step.expr = &expr;
+		stack.push_back(step);
+	}
+
+	void PushExpression(const ParsedExpression &expr, FunctionContext context, const ASTWalkState &state) {
+		ASTWalkStep step;
+		step.kind = ASTWalkStep::Kind::EXPRESSION;
+		step.state = state;
+		step.function_context = context;
+		step.expr = &expr;
+		stack.push_back(step);
+	}
+
+	void PushOptionalExpression(const unique_ptr<ParsedExpression> &expr, FunctionContext context,
+	                            const ASTWalkState &state) {
+		if (expr) {
+			PushExpression(*expr, context, state);
+		}
+	}
+
+	void WalkQueryNode(const QueryNode &node, const ASTWalkState &state, TableContext context,
+	                   const CommonTableExpressionMap *cte_map) {
+		ASTWalkState child_state = state;
+		child_state.statement_root = false;
+
+		if (node.type == QueryNodeType::SELECT_NODE) {
+			auto &select_node = (SelectNode &)node;
+			child_state.select_node = &select_node;
+			ASTWalkState clause_state = state;
+			clause_state.select_node = &select_node;
+
+			// CTE definitions first, each followed by its body
+			for (const auto &entry : select_node.cte_map.map) {
+				PushCTE(entry.first, child_state);
+				if (entry.second && entry.second->query && entry.second->query->node) {
+					PushQueryNode(*entry.second->query->node, child_state, TableContext::From, &select_node.cte_map);
+				}
+			}
+
+			if (visit_table_refs && select_node.from_table) {
+				PushTableRef(*select_node.from_table, child_state, context, true, &select_node.cte_map);
+			}
+
+			PushClauses(select_node, clause_state);
+		} else if (node.type == QueryNodeType::CTE_NODE) {
+			// additional step necessary for duckdb v1.4.0: unwrap CTE node
+			auto &cte_node = (CTENode &)node;
+			if (cte_node.child) {
+				PushQueryNode(*cte_node.child, child_state, context, cte_map);
+			}
+		}
+	}
+
+	void WalkTableRef(const TableRef &ref, const ASTWalkState &state, TableContext context, bool is_top_level,
+	                  const CommonTableExpressionMap *cte_map) {
+		switch (ref.type) {
+		case TableReferenceType::BASE_TABLE: {
+			auto &base = (BaseTableRef &)ref;
+			TableContext context_label = context;
+			if (cte_map && cte_map->map.find(base.table_name) != cte_map->map.end()) {
+				context_label = TableContext::FromCTE;
+			} else if (is_top_level) {
+				context_label = TableContext::From;
+			}
+			collectors.VisitBaseTable(base, context_label, state);
+			break;
+		}
+		case TableReferenceType::JOIN: {
+			auto &join = (JoinRef &)ref;
+			collectors.VisitJoin(join, state);
+			PushTableRef(*join.left, state, TableContext::JoinLeft, is_top_level, cte_map);
+			PushTableRef(*join.right, state, TableContext::JoinRight, false, cte_map);
+			if (collector_set_t::VISIT_JOIN_CONDITIONS && join.condition &&
+			    (!state.from_subquery || collector_set_t::VISIT_SUBQUERY_EXPRESSIONS)) {
+				ASTWalkState condition_state = state;
+				condition_state.clause = FunctionContext::Join;
+				PushExpression(*join.condition, FunctionContext::Join, condition_state);
+			}
+			break;
+		}
+		case TableReferenceType::SUBQUERY: {
+			auto &subquery = (SubqueryRef &)ref;
+			if (subquery.subquery && subquery.subquery->node) {
+				ASTWalkState subquery_state = state;
+				subquery_state.from_subquery = true;
+				PushQueryNode(*subquery.subquery->node, subquery_state, TableContext::Subquery, cte_map);
+			}
+			break;
+		}
+		default:
+			break;
+		}
+	}
+
+	void WalkClause(const ParsedExpression &expr, FunctionContext clause, const SelectNode &node,
+	                const ASTWalkState &state) {
+		ASTWalkState clause_state = state;
+		clause_state.clause = clause;
+		collectors.VisitClause(expr, clause, node, clause_state);
+		if (collector_set_t::VISIT_EXPRESSIONS &&
+		    (!state.from_subquery || collector_set_t::VISIT_SUBQUERY_EXPRESSIONS)) {
+			PushExpression(expr, clause, clause_state);
+		}
+	}
+
+	void PushClauses(const SelectNode &select_node, const ASTWalkState &state) {
+		for (const auto &expr : select_node.select_list) {
+			if (expr) {
+				PushClause(*expr, FunctionContext::Select, select_node, state);
+			}
+		}
+		if (select_node.where_clause) {
+			PushClause(*select_node.where_clause, FunctionContext::Where, select_node, state);
+		}
+		for (const auto &expr : select_node.groups.group_expressions) {
+			if (expr) {
+				PushClause(*expr, FunctionContext::GroupBy, select_node, state);
+			}
+		}
+		if (select_node.having) {
+			PushClause(*select_node.having, FunctionContext::Having, select_node, state);
+		}
+		for (const auto &modifier : select_node.modifiers) {
+			if (modifier->type != ResultModifierType::ORDER_MODIFIER) {
+				continue;
+			}
+			auto &order_modifier = (OrderModifier &)*modifier;
+			for (const auto &order : order_modifier.orders) {
+				if (order.expression) {
+					PushClause(*order.expression, FunctionContext::OrderBy, select_node, state);
+				}
+			}
+		}
+	}
+
+	void PushChildren(const ParsedExpression &expr, FunctionContext context, const ASTWalkState &state) {
+		ParsedExpressionIterator::EnumerateChildren(
+		    expr, [&](const ParsedExpression &child) { PushExpression(child, context, state); });
+	}
+
+	void WalkExpression(const ParsedExpression &expr, FunctionContext context, const ASTWalkState &state) {
+		if (expr.expression_class == ExpressionClass::FUNCTION) {
+			auto &func = (FunctionExpression &)expr;
+			collectors.VisitFunction(expr, func.function_name, func.schema, context, state);
+
+			// For nested function calls within this function, mark as nested
+			PushChildren(expr, FunctionContext::Nested, state);
+		} else if (expr.expression_class == ExpressionClass::WINDOW) {
+			auto &window_expr = (WindowExpression &)expr;
+			collectors.VisitFunction(expr, window_expr.function_name, window_expr.schema, context, state);
+
+			// arguments, PARTITION BY, ORDER BY, argument ordering, frame and filter expressions
+			ASTWalkState window_state = state;
+			window_state.clause = FunctionContext::WindowFunction;
+			for (const auto &child : window_expr.children) {
+				PushOptionalExpression(child, FunctionContext::Nested, state);
+			}
+			for (const auto &partition : window_expr.partitions) {
+				PushOptionalExpression(partition, FunctionContext::Nested, window_state);
+			}
+			for (const auto &order : window_expr.orders) {
+				PushOptionalExpression(order.expression, FunctionContext::Nested, window_state);
+			}
+			for (const auto &arg_order : window_expr.arg_orders) {
+				PushOptionalExpression(arg_order.expression, FunctionContext::Nested, state);
+			}
+			PushOptionalExpression(window_expr.start_expr, FunctionContext::Nested, state);
+			PushOptionalExpression(window_expr.end_expr, FunctionContext::Nested, state);
+			PushOptionalExpression(window_expr.offset_expr, FunctionContext::Nested, state);
+			PushOptionalExpression(window_expr.default_expr, FunctionContext::Nested, state);
+			PushOptionalExpression(window_expr.filter_expr, FunctionContext::Nested, state);
+		} else if (expr.expression_class == ExpressionClass::COLUMN_REF) {
+			collectors.VisitColumnRef((ColumnRefExpression &)expr, state);
+		} else {
+			// For non-function expressions, preserve the current context
+			PushChildren(expr, context, state);
+		}
+	}
+
+	collector_set_t collectors;
+	const bool visit_table_refs;
+	// the pending steps, reused across statements
+	vector<ASTWalkStep> stack;
+	idx_t max_steps = 0;
+	idx_t steps = 0;
+	bool budget_exhausted = false;
+};
+
+// Walks the statements once, reporting to all collectors
+template <class... COLLECTORS>
+void WalkStatements(const vector<unique_ptr<SQLStatement>> &statements, COLLECTORS &... collectors) {
+	ASTWalker<COLLECTORS...> walker(collectors...);
+	walker.WalkStatements(statements);
+}
+
+// Walks a single statement, e.g. to extract the results of a script statement by statement
+template <class... COLLECTORS>
+void WalkStatement(const SQLStatement &statement, COLLECTORS &... collectors) {
+	ASTWalker<COLLECTORS...> walker(collectors...);
+	walker.WalkStatement(statement);
+}
+
+} // namespace duckdb
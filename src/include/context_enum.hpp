@@ -0,0 +1,26 @@
+#pragma once
+
+#include "duckdb.hpp"
+
+namespace duckdb {
+
+// The context columns (table, function and condition contexts) are exposed as ENUM types rather than VARCHAR,
+// so that they are written as 1-byte codes and grouped or compared without hashing strings.
+// CONTEXT is an enum class with the values 0..count-1, named by ToString(CONTEXT).
+template <class CONTEXT>
+LogicalType CreateContextEnumType(idx_t count) {
+	Vector names(LogicalType::VARCHAR, count);
+	auto names_data = FlatVector::GetData<string_t>(names);
+	for (idx_t i = 0; i < count; i++) {
+		names_data[i] = StringVector::AddString(names, ToString(static_cast<CONTEXT>(i)));
+	}
+	return LogicalType::ENUM(names, count);
+}
+
+// Writes a context into a vector of its ENUM type (physical type UINT8)
+template <class CONTEXT>
+inline void SetContext(Vector &vector, idx_t idx, CONTEXT context) {
+	FlatVector::GetData<uint8_t>(vector)[idx] = static_cast<uint8_t>(context);
+}
+
+} // namespace duckdb
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "duckdb/common/string_map_set.hpp"
+#include <unordered_map>
+
+namespace duckdb {
+
+// Drop-in replacement for UnaryExecutor::Execute<string_t, RESULT_TYPE> for the scalar extractors.
+// Query logs are highly repetitive, so `fun` is only invoked once per distinct query of the chunk;
+// repeated rows receive a copy of the first result (for lists: an entry sharing the same child range).
+// Dictionary vectors are resolved by dictionary index first, so repeats are found without comparing strings.
+struct DeduplicatingExecutor {
+	template <class RESULT_TYPE, class FUNC>
+	static void Execute(Vector &input, Vector &result, idx_t count, FUNC &&fun) {
+		ExecuteWithNulls<RESULT_TYPE>(input, result, count, [&](string_t query, bool &is_null) -> RESULT_TYPE {
+			return fun(query);
+		});
+	}
+
+	// As Execute, for functions that may return NULL for a valid input: `fun(query, is_null)` sets `is_null`
+	// instead of returning a result
+	template <class RESULT_TYPE, class FUNC>
+	static void ExecuteWithNulls(Vector &input, Vector &result, idx_t count, FUNC &&fun) {
+		if (input.GetVectorType() == VectorType::CONSTANT_VECTOR) {
+			result.SetVectorType(VectorType::CONSTANT_VECTOR);
+			if (ConstantVector::IsNull(input)) {
+				ConstantVector::SetNull(result, true);
+				return;
+			}
+			auto input_data = ConstantVector::GetData<string_t>(input);
+			bool is_null = false;
+			ConstantVector::GetData<RESULT_TYPE>(result)[0] = fun(input_data[0], is_null);
+			if (is_null) {
+				ConstantVector::SetNull(result, true);
+			}
+			return;
+		}
+
+		result.SetVectorType(VectorType::FLAT_VECTOR);
+		auto result_data = FlatVector::GetData<RESULT_TYPE>(result);
+		auto &result_validity = FlatVector::Validity(result);
+
+		UnifiedVectorFormat format;
+		input.ToUnifiedFormat(count, format);
+		auto input_data = UnifiedVectorFormat::GetData<string_t>(format);
+
+		struct Result {
+			RESULT_TYPE value;
+			bool is_null;
+		};
+		bool is_dictionary = input.GetVectorType() == VectorType::DICTIONARY_VECTOR;
+		std::unordered_map<idx_t, Result> index_results;
+		string_map_t<Result> value_results;
+
+		for (idx_t i = 0; i < count; i++) {
+			auto idx = format.sel->get_index(i);
+			if (!format.validity.RowIsValid(idx)) {
+				result_validity.SetInvalid(i);
+				continue;
+			}
+			const Result *row_result = nullptr;
+			if (is_dictionary) {
+				auto entry = index_results.find(idx);
+				if (entry != index_results.end()) {
+					row_result = &entry->second;
+				}
+			}
+			if (!row_result) {
+				auto &query = input_data[idx];
+				auto entry = value_results.find(query);
+				if (entry == value_results.end()) {
+					Result computed;
+					computed.is_null = false;
+					computed.value = fun(query, computed.is_null);
+					entry = value_results.emplace(query, computed).first;
+				}
+				if (is_dictionary) {
+					index_results.emplace(idx, entry->second);
+				}
+				row_result = &entry->second;
+			}
+			if (row_result->is_null) {
+				result_validity.SetInvalid(i);
+			} else {
+				result_data[i] = row_result->value;
+			}
+		}
+	}
+};
+
+} // namespace duckdb
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "parse_cache.hpp"
+
+namespace duckdb {
+
+// Two-pass materialization for the list-returning scalar functions.
+// The rows of a chunk are first extracted into a single flat result vector (Append, one call per distinct query);
+// Finalize then reserves the list child once with the exact size and writes all results in one go,
+// so that STRUCT children can be filled field by field instead of growing every field vector row by row.
+// The time spent in both, and the results, are added to `counters`.
+template <class RESULT>
+struct ListResultBuilder {
+	ListResultBuilder(Vector &list_vector_p, ParserToolsCounters &counters_p)
+	    : list_vector(list_vector_p), base_offset(ListVector::GetListSize(list_vector_p)), counters(counters_p) {
+	}
+
+	// Appends the results of one row: `extract(results)` adds them to the back of the vector.
+	// `parsed` is kept alive until Finalize, as the results may point into it.
+	// Queries skipped for one of the limits have no results: `is_null` is set instead
+	template <class EXTRACT>
+	list_entry_t Append(shared_ptr<const ParsedQuery> parsed, bool &is_null, EXTRACT &&extract) {
+		if (parsed->SkippedByLimit()) {
+			is_null = true;
+			return list_entry_t();
+		}
+		auto offset = results.size();
+		{
+			StatsTimer timer(counters.walk_ns);
+			extract(results);
+		}
+		auto length = results.size() - offset;
+		counters.rows += length;
+		if (length > 0) {
+			parsed_queries.push_back(std::move(parsed));
+		}
+		return list_entry_t(base_offset + offset, length);
+	}
+
+	// Writes all results into the list child: `write(child, offset, results)` fills the child from `offset` on
+	template <class WRITE>
+	void Finalize(WRITE &&write) {
+		StatsTimer timer(counters.materialize_ns);
+		auto new_size = base_offset + results.size();
+		if (ListVector::GetListCapacity(list_vector) < new_size) {
+			ListVector::Reserve(list_vector, new_size);
+		}
+		write(ListVector::GetEntry(list_vector), base_offset, results);
+		ListVector::SetListSize(list_vector, new_size);
+	}
+
+	Vector &list_vector;
+	idx_t base_offset;
+	vector<RESULT> results;
+	vector<shared_ptr<const ParsedQuery>> parsed_queries;
+	ParserToolsCounters &counters;
+};
+
+} // namespace duckdb
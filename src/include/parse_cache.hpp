@@ -0,0 +1,167 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "sql_prefilter.hpp"
+#include "parser_tools_stats.hpp"
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/parser/parser.hpp"
+#include "duckdb/parser/parser_options.hpp"
+#include "duckdb/storage/object_cache.hpp"
+#include <list>
+#include <unordered_map>
+
+namespace duckdb {
+
+// Forward declarations
+class ExtensionLoader;
+class TaskScheduler;
+
+// Schema reported for unqualified table and function names. Short enough to be stored inline in a string_t
+static constexpr const char *DEFAULT_SCHEMA_NAME = "main";
+
+// The limit a query was skipped for, see CachedParser
+enum class ParseLimit : uint8_t {
+	None,
+	// larger than parser_tools_max_query_bytes: not parsed at all
+	QueryBytes,
+	// parsed, but with more nodes than parser_tools_max_nodes
+	Nodes
+};
+
+// The result of parsing a query: the statement list, or success = false and the error if the parser rejected it.
+// Instances are immutable once parsed so that they can be shared between threads through the cache.
+struct ParsedQuery {
+	vector<unique_ptr<SQLStatement>> statements;
+	bool success = false;
+	string error;
+	// for queries over one of the limits (success = false): which one. The scalar functions return NULL for them
+	ParseLimit limit = ParseLimit::None;
+
+	bool SkippedByLimit() const {
+		return limit != ParseLimit::None;
+	}
+	// byte offset of the error in the query, if known
+	optional_idx error_location;
+	// for parses restored from parse_to_blob: the query text the statement locations refer to
+	string sql;
+};
+
+// Database-instance-level LRU cache of parsed queries, shared by all parser_tools functions.
+// Entries are keyed by the hash of the query text and the parser options it was parsed with;
+// the text itself is kept to resolve collisions.
+class ParseCache : public ObjectCacheEntry {
+public:
+	static string ObjectType() {
+		return "parser_tools_parse_cache";
+	}
+	string GetObjectType() override {
+		return ObjectType();
+	}
+
+	static shared_ptr<ParseCache> Get(ClientContext &context);
+
+	shared_ptr<const ParsedQuery> Lookup(const char *sql, idx_t size, hash_t hash, idx_t options_key);
+	void Insert(const char *sql, idx_t size, hash_t hash, idx_t options_key, shared_ptr<const ParsedQuery> parsed,
+	            idx_t capacity);
+
+private:
+	struct Entry {
+		string sql;
+		hash_t hash;
+		idx_t options_key;
+		shared_ptr<const ParsedQuery> parsed;
+		idx_t size;
+	};
+
+	void Evict(idx_t capacity);
+
+	mutex lock;
+	// most recently used entries are at the front
+	std::list<Entry> entries;
+	std::unordered_map<hash_t, std::list<Entry>::iterator> index;
+	idx_t current_size = 0;
+};
+
+// The settings a CachedParser works with, resolved from the client context. Functions that have no client
+// context at execution time (aggregates) resolve them at bind time and construct their parsers from them.
+struct ParserSettings {
+	ParserOptions options;
+	// null if the cache is disabled
+	shared_ptr<ParseCache> cache;
+	idx_t capacity;
+	bool prefilter;
+	// scripts of at least this many bytes are split into statements and parsed on all threads (0: never)
+	idx_t parallel_parse_size;
+	// queries larger than this many bytes, or whose tree has more than this many nodes, are not extracted from
+	// (0: no limit)
+	idx_t max_query_bytes;
+	idx_t max_nodes;
+	TaskScheduler *scheduler;
+	// the totals parsers flush their counters into
+	shared_ptr<ParserToolsStats> stats;
+
+	static ParserSettings Get(ClientContext &context, const ParserOptions &options);
+};
+
+// Parses queries for the parser_tools functions, going through the instance-level cache when it is enabled.
+// Settings are resolved once on construction and the Parser is reused between rows, so keep one per thread
+// (e.g. in the function's local state) rather than creating one per row.
+// With a Tables or Functions target, queries the prefilter rules out are not parsed at all: they return an
+// empty (successful) parse instead. Queries over the max_query_bytes or max_nodes limits come back as a failed parse
+// whose error names the limit and whose `limit` is set, so that every extractor skips them.
+// The parser also keeps the parser_tools_stats() counters of the function it parses for, on the thread it is used
+// on: Parse counts the queries and their parse time, the callers add the extraction and output time through
+// Counters(). They are flushed into the totals when the parser is destroyed.
+class CachedParser {
+public:
+	CachedParser(ClientContext &context, string function_name);
+	CachedParser(ClientContext &context, const ParserOptions &options, string function_name);
+	CachedParser(const ParserSettings &settings, string function_name);
+	~CachedParser();
+
+	shared_ptr<const ParsedQuery> Parse(const char *sql, idx_t size, ParseTarget target = ParseTarget::Any);
+	shared_ptr<const ParsedQuery> Parse(const string_t &sql, ParseTarget target = ParseTarget::Any) {
+		return Parse(sql.GetData(), sql.GetSize(), target);
+	}
+	shared_ptr<const ParsedQuery> Parse(const string &sql, ParseTarget target = ParseTarget::Any) {
+		return Parse(sql.c_str(), sql.size(), target);
+	}
+	// Restores a parse serialized by parse_to_blob, without parsing. It bypasses the cache and the prefilter;
+	// the limits apply, max_query_bytes to the size of the blob
+	shared_ptr<const ParsedQuery> Deserialize(const string_t &blob);
+	// Parses the query argument of a function: SQL text, or a BLOB of parse_to_blob if `serialized`
+	shared_ptr<const ParsedQuery> ParseArgument(const string_t &input, bool serialized,
+	                                            ParseTarget target = ParseTarget::Any) {
+		return serialized ? Deserialize(input) : Parse(input, target);
+	}
+
+	ParserToolsCounters &Counters() {
+		return counters;
+	}
+
+private:
+	shared_ptr<const ParsedQuery> ParseInternal(const char *sql, idx_t size, ParseTarget target);
+	shared_ptr<const ParsedQuery> DeserializeInternal(const char *data, idx_t size);
+	shared_ptr<const ParsedQuery> ParseUncached(const char *sql, idx_t size);
+	shared_ptr<const ParsedQuery> ParseParallel(const char *sql, idx_t size);
+	bool ExceedsNodeBudget(const ParsedQuery &parsed) const;
+
+	ParserOptions options;
+	// fallback for queries the fast path cannot handle
+	Parser parser;
+	idx_t options_key;
+	shared_ptr<ParseCache> cache;
+	idx_t capacity;
+	bool prefilter;
+	idx_t parallel_parse_size;
+	idx_t max_query_bytes;
+	idx_t max_nodes;
+	TaskScheduler *scheduler;
+	shared_ptr<ParserToolsStats> stats;
+	string function_name;
+	ParserToolsCounters counters;
+};
+
+void RegisterParseCacheSettings(ExtensionLoader &loader);
+
+} // namespace duckdb
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "parse_functions.hpp"
+#include <vector>
+
+namespace duckdb {
+
+// Forward declarations
+class ExtensionLoader;
+
+// A column reference and the clause it appears in, reusing the function contexts: select, where, having, order_by,
+// group_by, join (JOIN ... ON conditions) and window (PARTITION BY and ORDER BY of a window).
+// The names are views into the parsed statements, so a result is only valid while its ParsedQuery is alive
+struct ColumnResult {
+	// the qualifier of the column (table name or alias); for unqualified columns, the alias or table name of the
+	// single source of the FROM clause, empty if there is none or the FROM clause is a join
+	string_t table_name;
+	string_t column_name;
+	FunctionContext context;
+};
+
+// Extracts the column references of all SELECT statements from an already parsed statement list
+void ExtractColumnsFromStatements(const vector<unique_ptr<SQLStatement>> &statements, std::vector<ColumnResult> &results);
+// The same for a single statement
+void ExtractColumnsFromStatement(const SQLStatement &statement, std::vector<ColumnResult> &results);
+
+void RegisterParseColumnsFunction(ExtensionLoader &loader);
+
+} // namespace duckdb
@@ -9,12 +9,34 @@ namespace duckdb {
 // Forward declarations
 class ExtensionLoader;
 
+enum class FunctionContext {
+	Select,
+	Where,
+	Having,
+	OrderBy,
+	GroupBy,
+	Join,
+	WindowFunction,
+	Nested
+};
+
+const char *ToString(FunctionContext context);
+
+// The ENUM type of the context columns: select, where, having, order_by, group_by, join, window, nested
+LogicalType FunctionContextType();
+
+// The names are views into the parsed statements, so a result is only valid while its ParsedQuery is alive
 struct FunctionResult {
-	std::string function_name;
-	std::string schema;
-	std::string context;     // The context where this function appears (SELECT, WHERE, etc.)
+	string_t function_name;
+	string_t schema;
+	FunctionContext context;     // The context where this function appears (SELECT, WHERE, etc.)
 };
 
+// Extracts the function calls of all SELECT statements from an already parsed statement list
+void ExtractFunctionsFromStatements(const vector<unique_ptr<SQLStatement>> &statements, std::vector<FunctionResult> &results);
+// The same for a single statement
+void ExtractFunctionsFromStatement(const SQLStatement &statement, std::vector<FunctionResult> &results);
+
 void RegisterParseFunctionsFunction(ExtensionLoader &loader);
 void RegisterParseFunctionScalarFunction(ExtensionLoader &loader);
 
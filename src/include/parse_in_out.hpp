@@ -0,0 +1,134 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "parse_cache.hpp"
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace duckdb {
+
+// Shared scaffolding for the table in-out (LATERAL) variants of the parse_* table functions.
+// These consume a column of queries chunk by chunk and stream out one row per extracted element,
+// prefixed with a row_id identifying the input query.
+
+struct ParseInOutBindData : public TableFunctionData {
+	ParseInOutBindData(string function_name_p, ParserOptions options_p, ParseTarget target_p = ParseTarget::Any)
+	    : function_name(std::move(function_name_p)), options(std::move(options_p)), target(target_p) {
+	}
+
+	// the name parser_tools_stats() reports the function under
+	string function_name;
+	// the client's parser options, captured at bind time
+	ParserOptions options;
+	// what is extracted from the queries, selecting the prefilter
+	ParseTarget target;
+};
+
+struct ParseInOutGlobalState : public GlobalTableFunctionState {
+	// row ids are handed out per input chunk, so they are unique across all threads
+	atomic<idx_t> next_row_id {0};
+
+	idx_t MaxThreads() const override {
+		return GlobalTableFunctionState::MAX_THREADS;
+	}
+};
+
+template <class RESULT>
+struct ParseInOutLocalState : public LocalTableFunctionState {
+	ParseInOutLocalState(ClientContext &context, const ParserOptions &options, const string &function_name)
+	    : parser(context, options, function_name) {
+	}
+
+	// reused for every input chunk this thread processes
+	CachedParser parser;
+	bool initialized = false;
+	idx_t row = 0;
+	// the parsed queries of the current input chunk, which own the strings the results may point into
+	vector<shared_ptr<const ParsedQuery>> parsed_queries;
+	std::vector<std::pair<idx_t, RESULT>> results;
+};
+
+static inline unique_ptr<GlobalTableFunctionState> ParseInOutInitGlobal(ClientContext &context,
+                                                                        TableFunctionInitInput &input) {
+	return make_uniq<ParseInOutGlobalState>();
+}
+
+template <class RESULT>
+static unique_ptr<LocalTableFunctionState> ParseInOutInitLocal(ExecutionContext &context, TableFunctionInitInput &input,
+                                                               GlobalTableFunctionState *global_state) {
+	auto &bind_data = (const ParseInOutBindData &)*input.bind_data;
+	return make_uniq<ParseInOutLocalState<RESULT>>(context.client, bind_data.options, bind_data.function_name);
+}
+
+// Extracts the results of every query in the input chunk and writes them to the output.
+// `extract(parsed, results)` fills a vector<RESULT> for a single parsed query;
+// `write(output, idx, result)` writes the result columns that follow row_id at position idx.
+// Returns HAVE_MORE_OUTPUT while results of the current input chunk remain to be emitted.
+template <class RESULT, class EXTRACT, class WRITE>
+static OperatorResultType ParseInOutExecute(ExecutionContext &context, TableFunctionInput &data, DataChunk &input,
+                                            DataChunk &output, EXTRACT &&extract, WRITE &&write) {
+	auto &bind_data = (const ParseInOutBindData &)*data.bind_data;
+	auto &global_state = (ParseInOutGlobalState &)*data.global_state;
+	auto &state = (ParseInOutLocalState<RESULT> &)*data.local_state;
+
+	auto &counters = state.parser.Counters();
+	if (!state.initialized) {
+		state.results.clear();
+		state.parsed_queries.clear();
+		state.row = 0;
+
+		auto row_id_base = global_state.next_row_id.fetch_add(input.size());
+
+		UnifiedVectorFormat sql_format;
+		input.data[0].ToUnifiedFormat(input.size(), sql_format);
+		auto sql_data = UnifiedVectorFormat::GetData<string_t>(sql_format);
+
+		vector<RESULT> row_results;
+		for (idx_t i = 0; i < input.size(); i++) {
+			auto idx = sql_format.sel->get_index(i);
+			if (!sql_format.validity.RowIsValid(idx)) {
+				continue;
+			}
+			row_results.clear();
+			auto parsed = state.parser.Parse(sql_data[idx], bind_data.target);
+			{
+				StatsTimer timer(counters.walk_ns);
+				extract(*parsed, row_results);
+			}
+			counters.rows += row_results.size();
+			if (row_results.empty()) {
+				continue;
+			}
+			for (auto &result : row_results) {
+				state.results.emplace_back(row_id_base + i, std::move(result));
+			}
+			state.parsed_queries.push_back(std::move(parsed));
+		}
+		state.initialized = true;
+	}
+
+	auto row_id_data = FlatVector::GetData<int64_t>(output.data[0]);
+
+	idx_t count = 0;
+	{
+		StatsTimer timer(counters.materialize_ns);
+		while (state.row < state.results.size() && count < STANDARD_VECTOR_SIZE) {
+			auto &entry = state.results[state.row];
+			row_id_data[count] = static_cast<int64_t>(entry.first);
+			write(output, count, entry.second);
+			state.row++;
+			count++;
+		}
+	}
+	output.SetCardinality(count);
+
+	if (state.row < state.results.size()) {
+		return OperatorResultType::HAVE_MORE_OUTPUT;
+	}
+	// this input chunk is exhausted, compute the next one on the following call
+	state.initialized = false;
+	return OperatorResultType::NEED_MORE_INPUT;
+}
+
+} // namespace duckdb
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "duckdb/parser/tableref/joinref.hpp"
+#include <string>
+#include <vector>
+
+namespace duckdb {
+
+// Forward declarations
+class ExtensionLoader;
+
+// An edge of the join graph: two sources of a join and the equi-join keys connecting them.
+// A join whose ON condition equates columns of several pairs of sources (a JOIN b ON ... JOIN c ON a.x = c.x AND
+// b.y = c.y) yields one edge per pair; a join without equi-join keys (CROSS JOIN, theta joins) a single edge
+// between its sides, whose tables are empty where a side is itself a join.
+struct JoinResult {
+	std::string left_table;   // the base table, empty for subqueries and table functions
+	std::string left_alias;   // the alias, empty if none
+	std::string right_table;
+	std::string right_alias;
+	std::string join_type;    // inner, left, right, full, semi, anti, cross, positional, with natural/asof prefixes
+	vector<string> left_keys; // the key columns, pairwise equal
+	vector<string> right_keys;
+};
+
+// Appends the edges of a single join
+void ExtractJoinEdges(const JoinRef &join, std::vector<JoinResult> &results);
+
+// Extracts the join edges of all SELECT statements from an already parsed statement list
+void ExtractJoinsFromStatements(const vector<unique_ptr<SQLStatement>> &statements, std::vector<JoinResult> &results);
+// The same for a single statement
+void ExtractJoinsFromStatement(const SQLStatement &statement, std::vector<JoinResult> &results);
+
+void RegisterParseJoinsFunction(ExtensionLoader &loader);
+
+} // namespace duckdb
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "parse_cache.hpp"
+#include "projected_columns.hpp"
+#include "statement_cursor.hpp"
+#include "duckdb/common/file_system.hpp"
+
+namespace duckdb {
+
+// Shared scaffolding for the file scan variants of the parse_* table functions (parse_tables_scan('models/*.sql')).
+// The files matching a glob are handed out one at a time to the worker threads; each thread reads and parses its
+// file and streams out its results, prefixed with a filename column.
+
+struct ParseScanBindData : public TableFunctionData {
+	ParseScanBindData(string function_name_p, vector<string> files_p, ParserOptions options_p, ParseTarget target_p)
+	    : function_name(std::move(function_name_p)), files(std::move(files_p)), options(std::move(options_p)),
+	      target(target_p) {
+	}
+
+	// the name parser_tools_stats() reports the function under
+	string function_name;
+	vector<string> files;
+	// the client's parser options, captured at bind time
+	ParserOptions options;
+	// what is extracted from the files, selecting the prefilter
+	ParseTarget target;
+};
+
+struct ParseScanGlobalState : public GlobalTableFunctionState {
+	ParseScanGlobalState(idx_t file_count_p, const vector<column_t> &column_ids)
+	    : file_count(file_count_p), projection(column_ids) {
+	}
+
+	// the next file to hand out
+	atomic<idx_t> next_file {0};
+	idx_t file_count;
+	// column 0 is the filename, the result columns follow
+	ProjectedColumns projection;
+
+	idx_t MaxThreads() const override {
+		return MaxValue<idx_t>(file_count, 1);
+	}
+};
+
+template <class RESULT>
+struct ParseScanLocalState : public LocalTableFunctionState {
+	ParseScanLocalState(ClientContext &context, const ParserOptions &options, const string &function_name)
+	    : parser(context, options, function_name) {
+	}
+
+	// reused for every file this thread processes
+	CachedParser parser;
+	// the current file: its name, its text and parse, which own the strings the results may point into
+	string filename;
+	string contents;
+	StatementCursor<RESULT> cursor;
+};
+
+// Expands the glob of the first argument; no matching file is an error
+static inline vector<string> GlobQueryFiles(ClientContext &context, const string &pattern) {
+	auto &fs = FileSystem::GetFileSystem(context);
+	vector<string> files;
+	for (auto &file : fs.GlobFiles(pattern, context, FileGlobOptions::DISALLOW_EMPTY)) {
+		files.push_back(file.path);
+	}
+	return files;
+}
+
+static inline unique_ptr<GlobalTableFunctionState> ParseScanInitGlobal(ClientContext &context,
+                                                                       TableFunctionInitInput &input) {
+	auto &bind_data = (const ParseScanBindData &)*input.bind_data;
+	return make_uniq<ParseScanGlobalState>(bind_data.files.size(), input.column_ids);
+}
+
+template <class RESULT>
+static unique_ptr<LocalTableFunctionState> ParseScanInitLocal(ExecutionContext &context, TableFunctionInitInput &input,
+                                                              GlobalTableFunctionState *global_state) {
+	auto &bind_data = (const ParseScanBindData &)*input.bind_data;
+	return make_uniq<ParseScanLocalState<RESULT>>(context.client, bind_data.options, bind_data.function_name);
+}
+
+// Emits the next chunk of results of this thread, claiming and parsing new files as the current one runs out.
+// `extract(statement, contents, results)` appends the results of one statement of the current file;
+// `write(column_id, vector, results, offset, count)` writes a result column as the single-query table function does
+template <class RESULT, class EXTRACT, class WRITE>
+static void ParseScanExecute(ClientContext &context, TableFunctionInput &data, DataChunk &output, EXTRACT &&extract,
+                             WRITE &&write) {
+	auto &bind_data = (const ParseScanBindData &)*data.bind_data;
+	auto &global_state = (ParseScanGlobalState &)*data.global_state;
+	auto &state = (ParseScanLocalState<RESULT> &)*data.local_state;
+
+	auto &cursor = state.cursor;
+	while (!cursor.Next([&](const SQLStatement &statement, vector<RESULT> &results) {
+		extract(statement, state.contents, results);
+	})) {
+		auto file_idx = global_state.next_file.fetch_add(1);
+		if (file_idx >= bind_data.files.size()) {
+			output.SetCardinality(0);
+			return;
+		}
+		auto &fs = FileSystem::GetFileSystem(context);
+		state.filename = bind_data.files[file_idx];
+		auto handle = fs.OpenFile(state.filename, FileFlags::FILE_FLAGS_READ);
+		auto size = NumericCast<idx_t>(handle->GetFileSize());
+		state.contents.resize(size);
+		handle->Read((void *)state.contents.data(), size, 0);
+
+		cursor.Reset(state.parser.Parse(state.contents, bind_data.target), state.parser.Counters());
+	}
+
+	auto count = cursor.ChunkSize();
+	global_state.projection.Write(output, cursor.row, count, state.parser.Counters(),
+	                              [&](column_t column_id, Vector &vector, idx_t offset, idx_t count) -> bool {
+		                              if (column_id == 0) {
+			                              vector.Reference(Value(state.filename));
+			                              return true;
+		                              }
+		                              return write(column_id - 1, vector, cursor.results, offset, count);
+	                              });
+	cursor.row += count;
+}
+
+} // namespace duckdb
@@ -19,19 +19,39 @@ enum class TableContext {
 const char *ToString(TableContext context);
 const TableContext FromString(const char *context);
 
+// The ENUM type of the context columns: from, join_left, join_right, from_cte, cte, subquery
+LogicalType TableContextType();
+
+// A set of table contexts, one bit per TableContext
+typedef uint32_t table_context_mask_t;
+
+inline table_context_mask_t TableContextBit(TableContext context) {
+    return table_context_mask_t(1) << static_cast<uint32_t>(context);
+}
+
+static constexpr table_context_mask_t ALL_TABLE_CONTEXTS = (table_context_mask_t(1) << (static_cast<uint32_t>(TableContext::Subquery) + 1)) - 1;
+
+// parse_table_names(sql, true): everything but the CTE definitions and the references to them
+static constexpr table_context_mask_t NON_CTE_CONTEXTS =
+    ALL_TABLE_CONTEXTS & ~((table_context_mask_t(1) << static_cast<uint32_t>(TableContext::CTE)) |
+                           (table_context_mask_t(1) << static_cast<uint32_t>(TableContext::FromCTE)));
+
+// Resolves the contexts := [...] and exclude_contexts := [...] named parameters of a table function
+table_context_mask_t GetTableContextMask(const named_parameter_map_t &named_parameters);
+
+// The names are views into the parsed statements, so a result is only valid while its ParsedQuery is alive
 struct TableRefResult {
-    std::string schema;
-    std::string table;
+    string_t schema;
+    string_t table;
     TableContext context;
 };
 
-static void ExtractTablesFromSQL(const std::string &sql, std::vector<TableRefResult> &results);
-static void ExtractTablesFromQueryNode(
-    const duckdb::QueryNode &node,
-    std::vector<TableRefResult> &results,
-    const TableContext context = TableContext::From,
-    const duckdb::CommonTableExpressionMap *cte_map = nullptr
-);
+// Extracts the table references of all SELECT statements from an already parsed statement list
+void ExtractTablesFromStatements(const vector<unique_ptr<SQLStatement>> &statements, std::vector<TableRefResult> &results,
+                                 table_context_mask_t contexts = ALL_TABLE_CONTEXTS);
+// The same for a single statement
+void ExtractTablesFromStatement(const SQLStatement &statement, std::vector<TableRefResult> &results,
+                                table_context_mask_t contexts = ALL_TABLE_CONTEXTS);
 
 void RegisterParseTablesFunction(duckdb::ExtensionLoader &loader);
 void RegisterParseTableScalarFunction(ExtensionLoader &loader);
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "duckdb.hpp"
+#include "duckdb/parser/parsed_expression.hpp"
 #include <string>
 #include <vector>
 
@@ -9,10 +10,26 @@ namespace duckdb {
 // Forward declarations
 class ExtensionLoader;
 
+enum class ConditionContext : uint8_t {
+    Where,
+    Having
+};
+
+const char *ToString(ConditionContext context);
+
+// The ENUM type of the context columns: WHERE, HAVING
+LogicalType ConditionContextType();
+
 struct WhereConditionResult {
-    std::string condition;
+    // The condition expression, owned by the parsed statements. Rendering it is the costly part of the extraction,
+    // so it is only converted to SQL text when the condition is actually output
+    const ParsedExpression *expression;
     std::string table_name;  // The table this condition applies to (if determinable)
-    std::string context;     // The context where this condition appears (WHERE, HAVING, etc.)
+    ConditionContext context;     // The context where this condition appears (WHERE, HAVING)
+
+    string Condition() const {
+        return expression->ToString();
+    }
 };
 
 struct DetailedWhereConditionResult {
@@ -20,11 +37,21 @@ struct DetailedWhereConditionResult {
     std::string operator_type;   // The comparison operator (>, <, =, etc.)
     std::string value;          // The value being compared against
     std::string table_name;     // The table this condition applies to (if determinable)
-    std::string context;        // The context where this condition appears (WHERE, HAVING, etc.)
+    ConditionContext context;   // The context where this condition appears (WHERE, HAVING)
+
+    std::string qualified_column_name;  // The column reference as written, e.g. o.customer_id
+    std::string table_alias;            // The FROM clause alias the column resolves to (empty if unknown)
+    std::string resolved_table;         // The base table behind table_alias (empty if unknown)
+    bool is_literal = false;            // Whether the value is a constant, possibly cast (DATE '2024-01-01')
+    Value literal;                      // That constant with its original type
 };
 
+// Extracts the WHERE/HAVING conditions of all SELECT statements from an already parsed statement list
+void ExtractWhereConditionsFromStatements(const vector<unique_ptr<SQLStatement>> &statements, vector<WhereConditionResult> &results);
+
 void RegisterParseWhereFunction(ExtensionLoader &loader);
 void RegisterParseWhereScalarFunction(ExtensionLoader &loader);
 void RegisterParseWhereDetailedFunction(ExtensionLoader &loader);
+void RegisterParseWhereDetailedScalarFunction(ExtensionLoader &loader);
 
 } // namespace duckdb 
\ No newline at end of file
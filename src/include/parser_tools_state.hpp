@@ -0,0 +1,42 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "parse_cache.hpp"
+#include "duckdb/function/scalar_function.hpp"
+#include "duckdb/parser/parser_options.hpp"
+
+namespace duckdb {
+
+// Bind data shared by the parser_tools scalar functions: the client's parser options,
+// captured once at bind time rather than using the defaults for every row.
+struct ParserToolsBindData : public FunctionData {
+	explicit ParserToolsBindData(ParserOptions options_p) : options(std::move(options_p)) {
+	}
+
+	ParserOptions options;
+
+	unique_ptr<FunctionData> Copy() const override;
+	bool Equals(const FunctionData &other_p) const override;
+};
+
+// Per-thread state of the parser_tools scalar functions, holding a parser that is reused between rows
+struct ParserToolsLocalState : public FunctionLocalState {
+	ParserToolsLocalState(ClientContext &context, const ParserOptions &options, const string &function_name)
+	    : parser(context, options, function_name) {
+	}
+
+	CachedParser parser;
+
+	static ParserToolsLocalState &Get(ExpressionState &state);
+};
+
+// Whether the query argument of a scalar function is a BLOB of parse_to_blob rather than SQL text
+static inline bool IsSerializedArgument(const Vector &input) {
+	return input.GetType().id() == LogicalTypeId::BLOB;
+}
+
+// Creates a scalar function with the parser_tools bind and local state callbacks set
+ScalarFunction ParserToolsScalarFunction(const string &name, vector<LogicalType> arguments, LogicalType return_type,
+                                         scalar_function_t function);
+
+} // namespace duckdb
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/storage/object_cache.hpp"
+#include <chrono>
+#include <map>
+
+namespace duckdb {
+
+// Forward declarations
+class ExtensionLoader;
+
+// Instrumentation of the parser_tools functions, exposed by parser_tools_stats().
+// Every thread accumulates the counters of a function in the state it already keeps per thread (the CachedParser)
+// without any synchronization; they are added to the database-instance-level totals once, when that state is
+// destroyed at the end of the query.
+
+struct ParserToolsCounters {
+	// queries (scripts, files, blobs) the function parsed, including cache hits
+	idx_t calls = 0;
+	// results extracted
+	idx_t rows = 0;
+	idx_t input_bytes = 0;
+	// queries that did not parse, or were over one of the limits
+	idx_t parse_failures = 0;
+	idx_t cache_hits = 0;
+	idx_t cache_misses = 0;
+	idx_t parse_ns = 0;
+	idx_t walk_ns = 0;
+	idx_t materialize_ns = 0;
+
+	bool IsEmpty() const {
+		return calls == 0 && rows == 0;
+	}
+	void Add(const ParserToolsCounters &other);
+};
+
+// Adds the lifetime of the timer in nanoseconds to `target`
+class StatsTimer {
+public:
+	explicit StatsTimer(idx_t &target_p) : target(target_p), start(std::chrono::steady_clock::now()) {
+	}
+	~StatsTimer() {
+		auto elapsed = std::chrono::steady_clock::now() - start;
+		target += NumericCast<idx_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+	}
+
+private:
+	idx_t &target;
+	std::chrono::steady_clock::time_point start;
+};
+
+// The totals per function name, ordered by name
+class ParserToolsStats : public ObjectCacheEntry {
+public:
+	static string ObjectType() {
+		return "parser_tools_stats";
+	}
+	string GetObjectType() override {
+		return ObjectType();
+	}
+
+	static shared_ptr<ParserToolsStats> Get(ClientContext &context);
+
+	void Flush(const string &function_name, const ParserToolsCounters &counters);
+	std::map<string, ParserToolsCounters> Snapshot();
+	// Returns the totals and clears them
+	std::map<string, ParserToolsCounters> Reset();
+
+private:
+	mutex lock;
+	std::map<string, ParserToolsCounters> totals;
+};
+
+void RegisterParserToolsStatsFunctions(ExtensionLoader &loader);
+
+} // namespace duckdb
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "parser_tools_stats.hpp"
+
+namespace duckdb {
+
+// Projection pushdown for the parse_* table functions: only the columns in `column_ids` (as handed to the init
+// function) are computed and written, output column i holding the function's column column_ids[i].
+struct ProjectedColumns {
+	ProjectedColumns() {
+	}
+	explicit ProjectedColumns(const vector<column_t> &column_ids_p) : column_ids(column_ids_p) {
+	}
+
+	bool IsProjected(column_t column_id) const {
+		for (auto &id : column_ids) {
+			if (id == column_id) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// Writes `count` results starting at `offset` column by column.
+	// `write_column(column_id, vector, offset, count)` fills one output vector and returns false for column ids it
+	// does not know (e.g. the virtual row id of a count(*)), which are set to NULL. The time taken is added to
+	// `counters`.
+	template <class WRITE_COLUMN>
+	void Write(DataChunk &output, idx_t offset, idx_t count, ParserToolsCounters &counters,
+	           WRITE_COLUMN &&write_column) const {
+		StatsTimer timer(counters.materialize_ns);
+		for (idx_t col = 0; col < column_ids.size(); col++) {
+			auto &vector = output.data[col];
+			if (!write_column(column_ids[col], vector, offset, count)) {
+				vector.SetVectorType(VectorType::CONSTANT_VECTOR);
+				ConstantVector::SetNull(vector, true);
+			}
+		}
+		output.SetCardinality(count);
+	}
+
+	vector<column_t> column_ids;
+};
+
+} // namespace duckdb
@@ -0,0 +1,12 @@
+#pragma once
+
+#include "duckdb.hpp"
+
+namespace duckdb {
+
+// Forward declarations
+class ExtensionLoader;
+
+void RegisterReferencesTableScalarFunction(ExtensionLoader &loader);
+
+} // namespace duckdb
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "parse_cache.hpp"
+
+namespace duckdb {
+
+// Forward declarations
+class ExtensionLoader;
+
+// Parsed queries persisted as BLOBs (parse_to_blob), so that archived query logs are parsed once and walked many
+// times. The blob holds the query text and, per statement, its location and SELECT tree in DuckDB's binary
+// serialization format. Statements other than SELECT have no serialized form and are re-parsed from their text.
+
+// Serializes a successful parse of `sql`
+string SerializeParsedQuery(const ParsedQuery &parsed, const char *sql, idx_t size);
+
+// Restores a parse from a blob of SerializeParsedQuery. Blobs that are not one come back as a failed parse
+shared_ptr<ParsedQuery> DeserializeParsedQuery(const ParserOptions &options, const char *data, idx_t size);
+
+void RegisterParseToBlobFunction(ExtensionLoader &loader);
+
+} // namespace duckdb
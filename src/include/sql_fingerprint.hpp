@@ -0,0 +1,20 @@
+#pragma once
+
+#include "duckdb.hpp"
+
+namespace duckdb {
+
+// Forward declarations
+class ExtensionLoader;
+
+// Replaces the literals and parameters of the statements with numbered placeholders ($1, $2, ...), in place.
+// IN lists of literals collapse into a single placeholder, so that queries of the same shape normalize alike
+void NormalizeStatements(vector<unique_ptr<SQLStatement>> &statements);
+
+// Hashes the shape of the statements as NormalizeStatements would normalize them, without copying, modifying or
+// rendering the tree: equal for statements that normalize alike
+hash_t FingerprintStatements(const vector<unique_ptr<SQLStatement>> &statements);
+
+void RegisterSQLFingerprintScalarFunction(ExtensionLoader &loader);
+
+} // namespace duckdb
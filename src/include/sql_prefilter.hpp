@@ -0,0 +1,40 @@
+#pragma once
+
+#include "duckdb.hpp"
+
+namespace duckdb {
+
+// What the caller of CachedParser::Parse extracts from the parsed query, deciding which prefilter applies
+enum class ParseTarget : uint8_t {
+	// the full parse result is needed (statements of any type, parse errors)
+	Any,
+	// only the table references of SELECT statements
+	Tables,
+	// only the function calls of SELECT statements
+	Functions
+};
+
+// Cheap lexical checks on the raw query text, run before the full parse for the table and function extractors.
+// Query logs are dominated by SET / SHOW / COMMIT / PRAGMA statements and SELECT 1 heartbeats, none of which can
+// produce a table or function result. The checks are conservative: false means that the query certainly yields
+// no result for the target, true that it has to be parsed.
+struct SQLPrefilter {
+	// false if no statement of the query is a SELECT (or WITH / FROM / VALUES / TABLE / PIVOT ...) statement
+	// with anything but constants in it
+	static bool MayContainSelect(const char *sql, idx_t size);
+	// false if the query contains none of the keywords that introduce a table (FROM, TABLE, WITH, PIVOT, ...)
+	static bool MayContainTableKeyword(const char *sql, idx_t size);
+
+	static bool MayProduce(ParseTarget target, const char *sql, idx_t size) {
+		switch (target) {
+		case ParseTarget::Tables:
+			return MayContainTableKeyword(sql, size) && MayContainSelect(sql, size);
+		case ParseTarget::Functions:
+			return MayContainSelect(sql, size);
+		default:
+			return true;
+		}
+	}
+};
+
+} // namespace duckdb
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "parse_cache.hpp"
+
+namespace duckdb {
+
+// Lazy result generation for the table functions that emit the results of a whole script.
+// Instead of extracting every statement up front, the results are produced one batch of statements at a time,
+// each batch holding about one output chunk. Queries that stop early (LIMIT) skip the remaining statements, and only
+// a bounded number of results is held at any time.
+//
+// The script is still parsed as a whole, so that a syntax error anywhere yields no results as before. A parse that
+// is owned by the cursor alone (not in the parse cache, e.g. a script too large for it) additionally has the AST of
+// every consumed statement released once its results have been emitted.
+template <class RESULT>
+struct StatementCursor {
+	shared_ptr<const ParsedQuery> parsed;
+	// the results of the current batch, emitted from `row` on
+	vector<RESULT> results;
+	idx_t row = 0;
+
+	// `counters` receives the extraction time and the results, usually those of the parser of `parsed_p`
+	void Reset(shared_ptr<const ParsedQuery> parsed_p, ParserToolsCounters &counters_p) {
+		parsed = std::move(parsed_p);
+		counters = &counters_p;
+		results.clear();
+		row = 0;
+		next_statement = 0;
+		released = 0;
+	}
+
+	// Makes sure that results remain from `row` on, extracting the next batch of statements if needed:
+	// `extract(statement, results)` appends the results of a single statement. Returns false at the end of the script
+	template <class EXTRACT>
+	bool Next(EXTRACT &&extract) {
+		while (row >= results.size()) {
+			// the results of the previous batch have been emitted: their statements are no longer referenced
+			ReleaseConsumed();
+			if (!parsed || next_statement >= parsed->statements.size()) {
+				return false;
+			}
+			results.clear();
+			row = 0;
+			StatsTimer timer(counters->walk_ns);
+			while (next_statement < parsed->statements.size() && results.size() < STANDARD_VECTOR_SIZE) {
+				auto &statement = parsed->statements[next_statement++];
+				if (statement) {
+					extract(*statement, results);
+				}
+			}
+			counters->rows += results.size();
+		}
+		return true;
+	}
+
+	// The number of results to emit into the next output chunk
+	idx_t ChunkSize() const {
+		return MinValue<idx_t>(STANDARD_VECTOR_SIZE, results.size() - row);
+	}
+
+private:
+	void ReleaseConsumed() {
+		if (parsed.use_count() != 1) {
+			// shared with the parse cache (or another reader): leave it untouched
+			return;
+		}
+		// nobody else can observe this parse, so the consumed statements can be dropped in place
+		auto &statements = const_cast<ParsedQuery &>(*parsed).statements;
+		for (; released < next_statement; released++) {
+			statements[released].reset();
+		}
+	}
+
+	ParserToolsCounters *counters = nullptr;
+	idx_t next_statement = 0;
+	// the statements before this one have been released
+	idx_t released = 0;
+};
+
+} // namespace duckdb
@@ -0,0 +1,13 @@
+#pragma once
+
+#include "duckdb.hpp"
+
+namespace duckdb {
+
+// Splits a script at the semicolons that end its statements: those outside of string literals (including escape
+// strings), quoted identifiers, comments and dollar-quoted strings. Returns the end offset of every statement,
+// just past its semicolon; the last offset is `size` if text follows the last semicolon.
+// This only finds statement boundaries, it does not validate anything: the ranges still have to be parsed.
+vector<idx_t> SplitStatements(const char *sql, idx_t size);
+
+} // namespace duckdb
@@ -0,0 +1,12 @@
+#pragma once
+
+#include "duckdb.hpp"
+
+namespace duckdb {
+
+// Forward declarations
+class ExtensionLoader;
+
+void RegisterUsageAggregateFunctions(ExtensionLoader &loader);
+
+} // namespace duckdb
@@ -0,0 +1,141 @@
+#include "parse_all.hpp"
+#include "parse_cache.hpp"
+#include "parser_tools_state.hpp"
+#include "parse_tables.hpp"
+#include "parse_functions.hpp"
+#include "parse_where.hpp"
+#include "ast_collectors.hpp"
+#include "context_enum.hpp"
+#include "duckdb.hpp"
+#include "duckdb/parser/parser.hpp"
+#include "duckdb/function/scalar/nested_functions.hpp"
+
+namespace duckdb {
+
+// Appends the results of one row to a LIST(STRUCT(...)) vector.
+// `write(entries, idx, result)` writes the STRUCT fields of a single result at child position idx.
+template <class RESULT, class WRITE>
+static void AppendStructList(Vector &list_vector, idx_t row, const std::vector<RESULT> &results, WRITE &&write) {
+	auto current_size = ListVector::GetListSize(list_vector);
+	auto new_size = current_size + results.size();
+
+	// grow list if needed
+	if (ListVector::GetListCapacity(list_vector) < new_size) {
+		ListVector::Reserve(list_vector, new_size);
+	}
+
+	auto &entries = StructVector::GetEntries(ListVector::GetEntry(list_vector));
+	for (idx_t i = 0; i < results.size(); i++) {
+		write(entries, current_size + i, results[i]);
+	}
+	ListVector::SetListSize(list_vector, new_size);
+
+	auto list_data = FlatVector::GetData<list_entry_t>(list_vector);
+	list_data[row] = list_entry_t(current_size, results.size());
+}
+
+template <class T>
+static inline void SetString(vector<unique_ptr<Vector>> &entries, idx_t field, idx_t idx, const T &value) {
+	auto &vector = *entries[field];
+	FlatVector::GetData<string_t>(vector)[idx] = StringVector::AddString(vector, value);
+}
+
+// parse_all parses the query once and runs every extractor over the same statement list
+static void ParseAllScalarFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto count = args.size();
+	auto &input = args.data[0];
+
+	auto &fields = StructVector::GetEntries(result);
+	auto &tables_vector = *fields[0];
+	auto &functions_vector = *fields[1];
+	auto &conditions_vector = *fields[2];
+	auto num_statements_data = FlatVector::GetData<int64_t>(*fields[3]);
+
+	UnifiedVectorFormat sql_format;
+	input.ToUnifiedFormat(count, sql_format);
+	auto sql_data = UnifiedVectorFormat::GetData<string_t>(sql_format);
+
+	auto &parser = ParserToolsLocalState::Get(state).parser;
+	auto &counters = parser.Counters();
+	for (idx_t row = 0; row < count; row++) {
+		auto idx = sql_format.sel->get_index(row);
+		if (!sql_format.validity.RowIsValid(idx)) {
+			FlatVector::SetNull(result, row, true);
+			continue;
+		}
+
+		std::vector<TableRefResult> tables;
+		std::vector<FunctionResult> functions;
+		vector<WhereConditionResult> conditions;
+
+		auto parsed = parser.Parse(sql_data[idx]);
+		if (parsed->SkippedByLimit()) {
+			FlatVector::SetNull(result, row, true);
+			continue;
+		}
+		{
+			// a single traversal feeds all three extractors
+			StatsTimer timer(counters.walk_ns);
+			TableCollector table_collector(tables);
+			FunctionCollector function_collector(functions);
+			WhereCollector where_collector(conditions);
+			WalkStatements(parsed->statements, table_collector, function_collector, where_collector);
+		}
+		idx_t statement_count = parsed->statements.size();
+		counters.rows += tables.size() + functions.size() + conditions.size();
+
+		StatsTimer timer(counters.materialize_ns);
+		AppendStructList(tables_vector, row, tables,
+		[](vector<unique_ptr<Vector>> &entries, idx_t i, const TableRefResult &table) {
+			SetString(entries, 0, i, table.schema);
+			SetString(entries, 1, i, table.table);
+			SetContext(*entries[2], i, table.context);
+		});
+		AppendStructList(functions_vector, row, functions,
+		[](vector<unique_ptr<Vector>> &entries, idx_t i, const FunctionResult &func) {
+			SetString(entries, 0, i, func.function_name);
+			SetString(entries, 1, i, func.schema);
+			SetContext(*entries[2], i, func.context);
+		});
+		AppendStructList(conditions_vector, row, conditions,
+		[](vector<unique_ptr<Vector>> &entries, idx_t i, const WhereConditionResult &condition) {
+			SetString(entries, 0, i, condition.Condition());
+			SetString(entries, 1, i, condition.table_name);
+			SetContext(*entries[2], i, condition.context);
+		});
+		num_statements_data[row] = static_cast<int64_t>(statement_count);
+	}
+
+	if (input.GetVectorType() == VectorType::CONSTANT_VECTOR) {
+		result.SetVectorType(VectorType::CONSTANT_VECTOR);
+	}
+}
+
+// Extension scaffolding
+// ---------------------------------------------------
+
+void RegisterParseAllScalarFunction(ExtensionLoader &loader) {
+	// parse_all returns every extraction of a single parse as one STRUCT
+	auto return_type = LogicalType::STRUCT({
+		{"tables", LogicalType::LIST(LogicalType::STRUCT({
+			{"schema", LogicalType::VARCHAR},
+			{"table", LogicalType::VARCHAR},
+			{"context", TableContextType()}
+		}))},
+		{"functions", LogicalType::LIST(LogicalType::STRUCT({
+			{"function_name", LogicalType::VARCHAR},
+			{"schema", LogicalType::VARCHAR},
+			{"context", FunctionContextType()}
+		}))},
+		{"where_conditions", LogicalType::LIST(LogicalType::STRUCT({
+			{"condition", LogicalType::VARCHAR},
+			{"table_name", LogicalType::VARCHAR},
+			{"context", ConditionContextType()}
+		}))},
+		{"num_statements", LogicalType::BIGINT}
+	});
+	auto sf = ParserToolsScalarFunction("parse_all", {LogicalType::VARCHAR}, return_type, ParseAllScalarFunction);
+	loader.RegisterFunction(sf);
+}
+
+} // namespace duckdb
@@ -0,0 +1,451 @@
+#include "parse_cache.hpp"
+#include "duckdb.hpp"
+#include "duckdb/common/types/hash.hpp"
+#include "duckdb/main/config.hpp"
+#include "duckdb/common/error_data.hpp"
+#include "duckdb/parser/parser.hpp"
+#include "duckdb/parser/transformer.hpp"
+#include "duckdb/parallel/task_executor.hpp"
+#include "duckdb/parallel/task_scheduler.hpp"
+#include "statement_splitter.hpp"
+#include "ast_walker.hpp"
+#include "serialized_query.hpp"
+#include "postgres_parser.hpp"
+
+namespace duckdb {
+
+static constexpr const char *CACHE_ENABLED_SETTING = "parser_tools_cache";
+static constexpr const char *CACHE_SIZE_SETTING = "parser_tools_cache_size";
+static constexpr const char *PREFILTER_SETTING = "parser_tools_prefilter";
+static constexpr const char *PARALLEL_PARSE_SIZE_SETTING = "parser_tools_parallel_parse_size";
+static constexpr const char *MAX_QUERY_BYTES_SETTING = "parser_tools_max_query_bytes";
+static constexpr const char *MAX_NODES_SETTING = "parser_tools_max_nodes";
+static constexpr idx_t DEFAULT_CACHE_SIZE = 64ULL * 1024ULL * 1024ULL;
+static constexpr idx_t DEFAULT_PARALLEL_PARSE_SIZE = 1024ULL * 1024ULL;
+
+// The parsed tree is not measured exactly; charge a multiple of the query text for it,
+// on top of the copy of the text that is kept as the key.
+static constexpr idx_t PARSED_SIZE_FACTOR = 8;
+static constexpr idx_t ENTRY_OVERHEAD = 256;
+
+static idx_t EstimateEntrySize(idx_t sql_size) {
+	return sql_size * (PARSED_SIZE_FACTOR + 1) + ENTRY_OVERHEAD;
+}
+
+shared_ptr<ParseCache> ParseCache::Get(ClientContext &context) {
+	return ObjectCache::GetObjectCache(context).GetOrCreate<ParseCache>(ObjectType());
+}
+
+shared_ptr<const ParsedQuery> ParseCache::Lookup(const char *sql, idx_t size, hash_t hash, idx_t options_key) {
+	lock_guard<mutex> guard(lock);
+	auto entry = index.find(hash);
+	if (entry == index.end()) {
+		return nullptr;
+	}
+	auto &cached = *entry->second;
+	if (cached.options_key != options_key || cached.sql.size() != size || memcmp(cached.sql.data(), sql, size) != 0) {
+		// hash collision with a different query
+		return nullptr;
+	}
+	// move to the front of the LRU list
+	entries.splice(entries.begin(), entries, entry->second);
+	return cached.parsed;
+}
+
+void ParseCache::Insert(const char *sql, idx_t size, hash_t hash, idx_t options_key, shared_ptr<const ParsedQuery> parsed,
+                        idx_t capacity) {
+	auto entry_size = EstimateEntrySize(size);
+	if (entry_size > capacity) {
+		return;
+	}
+
+	lock_guard<mutex> guard(lock);
+	auto existing = index.find(hash);
+	if (existing != index.end()) {
+		// either another thread inserted the same query concurrently or the hash collides: keep the newest
+		current_size -= existing->second->size;
+		entries.erase(existing->second);
+		index.erase(existing);
+	}
+	Evict(capacity - entry_size);
+
+	entries.push_front(Entry {string(sql, size), hash, options_key, std::move(parsed), entry_size});
+	index[hash] = entries.begin();
+	current_size += entry_size;
+}
+
+void ParseCache::Evict(idx_t capacity) {
+	while (current_size > capacity && !entries.empty()) {
+		auto &last = entries.back();
+		current_size -= last.size;
+		index.erase(last.hash);
+		entries.pop_back();
+	}
+}
+
+// The options that change the produced parse tree, packed into a single key
+static idx_t GetOptionsKey(const ParserOptions &options) {
+	return (options.max_expression_depth << 2) | (options.integer_division ? 2 : 0) |
+	       (options.preserve_identifier_case ? 1 : 0);
+}
+
+ParserSettings ParserSettings::Get(ClientContext &context, const ParserOptions &options) {
+	ParserSettings settings;
+	settings.options = options;
+	settings.capacity = DEFAULT_CACHE_SIZE;
+	settings.prefilter = true;
+	settings.parallel_parse_size = DEFAULT_PARALLEL_PARSE_SIZE;
+	settings.max_query_bytes = 0;
+	settings.max_nodes = 0;
+	settings.scheduler = &TaskScheduler::GetScheduler(context);
+	Value value;
+	bool enabled = true;
+	if (context.TryGetCurrentSetting(CACHE_ENABLED_SETTING, value) && !value.IsNull()) {
+		enabled = BooleanValue::Get(value);
+	}
+	if (context.TryGetCurrentSetting(CACHE_SIZE_SETTING, value) && !value.IsNull()) {
+		settings.capacity = UBigIntValue::Get(value);
+	}
+	if (context.TryGetCurrentSetting(PREFILTER_SETTING, value) && !value.IsNull()) {
+		settings.prefilter = BooleanValue::Get(value);
+	}
+	if (context.TryGetCurrentSetting(PARALLEL_PARSE_SIZE_SETTING, value) && !value.IsNull()) {
+		settings.parallel_parse_size = UBigIntValue::Get(value);
+	}
+	if (context.TryGetCurrentSetting(MAX_QUERY_BYTES_SETTING, value) && !value.IsNull()) {
+		settings.max_query_bytes = UBigIntValue::Get(value);
+	}
+	if (context.TryGetCurrentSetting(MAX_NODES_SETTING, value) && !value.IsNull()) {
+		settings.max_nodes = UBigIntValue::Get(value);
+	}
+	if (enabled && settings.capacity > 0) {
+		settings.cache = ParseCache::Get(context);
+	}
+	settings.stats = ParserToolsStats::Get(context);
+	return settings;
+}
+
+CachedParser::CachedParser(ClientContext &context, string function_name)
+    : CachedParser(context, context.GetParserOptions(), std::move(function_name)) {
+}
+
+CachedParser::CachedParser(ClientContext &context, const ParserOptions &options, string function_name)
+    : CachedParser(ParserSettings::Get(context, options), std::move(function_name)) {
+}
+
+CachedParser::CachedParser(const ParserSettings &settings, string function_name_p)
+    : options(settings.options), parser(settings.options), options_key(GetOptionsKey(settings.options)),
+      cache(settings.cache), capacity(settings.capacity), prefilter(settings.prefilter),
+      parallel_parse_size(settings.parallel_parse_size), max_query_bytes(settings.max_query_bytes),
+      max_nodes(settings.max_nodes), scheduler(settings.scheduler), stats(settings.stats),
+      function_name(std::move(function_name_p)) {
+}
+
+CachedParser::~CachedParser() {
+	if (stats && !counters.IsEmpty()) {
+		stats->Flush(function_name, counters);
+	}
+}
+
+static bool HasNonAsciiCharacters(const char *sql, idx_t size) {
+	for (idx_t i = 0; i < size; i++) {
+		if (static_cast<unsigned char>(sql[i]) >= 0x80) {
+			return true;
+		}
+	}
+	return false;
+}
+
+// Runs the grammar and the transformer directly instead of going through Parser::ParseQuery,
+// so that syntax errors are reported through `result` instead of a ParserException per row.
+// Returns false if the input needs the full Parser: non-ASCII queries, which may contain unicode spaces that
+// Parser::ParseQuery strips first (the grammar would take them as part of an identifier), and queries that fail the
+// grammar but may still be accepted by a parser extension.
+static bool TryParseFast(const ParserOptions &options, const string &query, ParsedQuery &result) {
+	if (HasNonAsciiCharacters(query.c_str(), query.size())) {
+		return false;
+	}
+	PostgresParser::SetPreserveIdentifierCase(options.preserve_identifier_case);
+	PostgresParser pg_parser;
+	pg_parser.Parse(query);
+	if (!pg_parser.success) {
+		if (options.extensions && !options.extensions->empty()) {
+			return false;
+		}
+		result.error = pg_parser.error_message;
+		if (pg_parser.error_location > 0) {
+			result.error_location = NumericCast<idx_t>(pg_parser.error_location - 1);
+		}
+		return true;
+	}
+	if (!pg_parser.parse_tree) {
+		// empty statement
+		result.success = true;
+		return true;
+	}
+	try {
+		Transformer transformer(options);
+		transformer.TransformParseTree(pg_parser.parse_tree, result.statements);
+	} catch (const std::exception &ex) {
+		// the grammar accepted the query but the transformer did not (e.g. unsupported syntax)
+		result.statements.clear();
+		ErrorData error(ex);
+		result.error = error.RawMessage();
+		return true;
+	}
+	if (!result.statements.empty()) {
+		// as Parser::ParseQuery: the last statement extends to the end of the query
+		auto &last_statement = result.statements.back();
+		last_statement->stmt_length = query.size() - last_statement->stmt_location;
+	}
+	result.success = true;
+	return true;
+}
+
+// Parses `query` into `result`, through the fast path if possible and `parser` otherwise
+static void ParseQueryText(const ParserOptions &options, Parser &parser, const string &query, ParsedQuery &result) {
+	if (TryParseFast(options, query, result)) {
+		return;
+	}
+
+	// the parser is reused between rows: drop the statements of the previous parse
+	parser.statements.clear();
+	try {
+		parser.ParseQuery(query);
+		result.statements = std::move(parser.statements);
+		result.success = true;
+	} catch (const std::exception &ex) {
+		// swallow parser exceptions to make the extractors more robust. is_parsable can be used if needed
+		ErrorData error(ex);
+		result.error = error.RawMessage();
+		auto position = error.ExtraInfo().find("position");
+		if (position != error.ExtraInfo().end()) {
+			result.error_location = std::stoull(position->second);
+		}
+	}
+	parser.statements.clear();
+}
+
+shared_ptr<const ParsedQuery> CachedParser::ParseUncached(const char *sql, idx_t size) {
+	if (parallel_parse_size > 0 && size >= parallel_parse_size && scheduler && scheduler->NumberOfThreads() > 1) {
+		auto parsed = ParseParallel(sql, size);
+		if (parsed) {
+			return parsed;
+		}
+	}
+	auto result = make_shared_ptr<ParsedQuery>();
+	ParseQueryText(options, parser, string(sql, size), *result);
+	return std::move(result);
+}
+
+namespace {
+
+// Parses one batch of consecutive statements of a large script
+class ParseBatchTask : public BaseExecutorTask {
+public:
+	ParseBatchTask(TaskExecutor &executor, const ParserOptions &options_p, const char *sql_p, idx_t size_p,
+	               ParsedQuery &result_p)
+	    : BaseExecutorTask(executor), options(options_p), sql(sql_p), size(size_p), result(result_p) {
+	}
+
+	void ExecuteTask() override {
+		Parser parser(options);
+		ParseQueryText(options, parser, string(sql, size), result);
+	}
+
+private:
+	const ParserOptions &options;
+	const char *sql;
+	idx_t size;
+	ParsedQuery &result;
+};
+
+} // namespace
+
+// Splits a large script at its statement boundaries into one batch per thread, parses the batches on the task
+// scheduler and concatenates the statements in their original order.
+// Returns nullptr if the script has a single statement, which is parsed as is
+shared_ptr<const ParsedQuery> CachedParser::ParseParallel(const char *sql, idx_t size) {
+	auto statement_ends = SplitStatements(sql, size);
+	if (statement_ends.size() < 2) {
+		return nullptr;
+	}
+	auto batch_count = MinValue<idx_t>(NumericCast<idx_t>(scheduler->NumberOfThreads()), statement_ends.size());
+	auto batch_size = size / batch_count;
+
+	// batches of about batch_size bytes, cut at statement ends; the last one extends to the end of the script
+	vector<idx_t> batch_starts {0};
+	for (auto end : statement_ends) {
+		if (end < size && end - batch_starts.back() >= batch_size) {
+			batch_starts.push_back(end);
+		}
+	}
+	vector<ParsedQuery> batches(batch_starts.size());
+
+	TaskExecutor executor(*scheduler);
+	for (idx_t i = 0; i < batch_starts.size(); i++) {
+		auto start = batch_starts[i];
+		auto end = i + 1 < batch_starts.size() ? batch_starts[i + 1] : size;
+		executor.ScheduleTask(make_uniq<ParseBatchTask>(executor, options, sql + start, end - start, batches[i]));
+	}
+	executor.WorkOnTasks();
+
+	auto result = make_shared_ptr<ParsedQuery>();
+	for (idx_t i = 0; i < batches.size(); i++) {
+		auto &batch = batches[i];
+		if (!batch.success) {
+			// the first error of the script, as a serial parse reports it
+			result->statements.clear();
+			result->error = std::move(batch.error);
+			if (batch.error_location.IsValid()) {
+				result->error_location = batch_starts[i] + batch.error_location.GetIndex();
+			}
+			return std::move(result);
+		}
+		for (auto &stmt : batch.statements) {
+			stmt->stmt_location += batch_starts[i];
+			result->statements.push_back(std::move(stmt));
+		}
+	}
+	if (!result->statements.empty()) {
+		auto &last_statement = result->statements.back();
+		last_statement->stmt_length = size - last_statement->stmt_location;
+	}
+	result->success = true;
+	return std::move(result);
+}
+
+// The result for queries the prefilter rules out: no statements to extract anything from
+static shared_ptr<const ParsedQuery> EmptyParsedQuery() {
+	static const shared_ptr<const ParsedQuery> empty = []() {
+		auto result = make_shared_ptr<ParsedQuery>();
+		result->success = true;
+		return shared_ptr<const ParsedQuery>(std::move(result));
+	}();
+	return empty;
+}
+
+// The result for queries over one of the limits: a failed parse, so that the query is skipped by every extractor
+static shared_ptr<const ParsedQuery> LimitExceeded(ParseLimit limit, const string &error) {
+	auto result = make_shared_ptr<ParsedQuery>();
+	result->error = error;
+	result->limit = limit;
+	return std::move(result);
+}
+
+static shared_ptr<const ParsedQuery> QueryBytesExceeded(idx_t size, idx_t max_query_bytes) {
+	return LimitExceeded(ParseLimit::QueryBytes, "Query of " + to_string(size) + " bytes exceeds " +
+	                                                 MAX_QUERY_BYTES_SETTING + " (" + to_string(max_query_bytes) + ")");
+}
+
+static shared_ptr<const ParsedQuery> NodesExceeded(idx_t max_nodes) {
+	return LimitExceeded(ParseLimit::Nodes,
+	                     "Query exceeds " + string(MAX_NODES_SETTING) + " (" + to_string(max_nodes) + " nodes)");
+}
+
+// Visits all parts of the tree the extractors may walk, so that its steps count the nodes of the tree
+struct NodeCounter : public ASTCollector {
+	static constexpr bool VISIT_TABLE_REFS = true;
+	static constexpr bool VISIT_EXPRESSIONS = true;
+	static constexpr bool VISIT_SUBQUERY_EXPRESSIONS = true;
+	static constexpr bool VISIT_JOIN_CONDITIONS = true;
+};
+
+// Walks at most max_nodes nodes: the cost of the check is bounded by the limit, not by the size of the tree
+bool CachedParser::ExceedsNodeBudget(const ParsedQuery &parsed) const {
+	NodeCounter counter;
+	ASTWalker<NodeCounter> walker(counter);
+	walker.SetStepBudget(max_nodes);
+	walker.WalkStatements(parsed.statements);
+	return walker.BudgetExhausted();
+}
+
+shared_ptr<const ParsedQuery> CachedParser::Parse(const char *sql, idx_t size, ParseTarget target) {
+	StatsTimer timer(counters.parse_ns);
+	counters.calls++;
+	counters.input_bytes += size;
+	auto parsed = ParseInternal(sql, size, target);
+	if (!parsed->success) {
+		counters.parse_failures++;
+	}
+	return parsed;
+}
+
+shared_ptr<const ParsedQuery> CachedParser::ParseInternal(const char *sql, idx_t size, ParseTarget target) {
+	if (max_query_bytes > 0 && size > max_query_bytes) {
+		return QueryBytesExceeded(size, max_query_bytes);
+	}
+	if (prefilter && !SQLPrefilter::MayProduce(target, sql, size)) {
+		return EmptyParsedQuery();
+	}
+	shared_ptr<const ParsedQuery> parsed;
+	if (!cache) {
+		parsed = ParseUncached(sql, size);
+	} else {
+		auto hash = Hash(sql, size);
+		parsed = cache->Lookup(sql, size, hash, options_key);
+		if (parsed) {
+			counters.cache_hits++;
+		} else {
+			counters.cache_misses++;
+			parsed = ParseUncached(sql, size);
+			cache->Insert(sql, size, hash, options_key, parsed, capacity);
+		}
+	}
+	// the parse itself is cached regardless of the budget, which may be different for the next caller
+	if (max_nodes > 0 && parsed->success && ExceedsNodeBudget(*parsed)) {
+		return NodesExceeded(max_nodes);
+	}
+	return parsed;
+}
+
+shared_ptr<const ParsedQuery> CachedParser::Deserialize(const string_t &blob) {
+	StatsTimer timer(counters.parse_ns);
+	counters.calls++;
+	counters.input_bytes += blob.GetSize();
+	auto parsed = DeserializeInternal(blob.GetData(), blob.GetSize());
+	if (!parsed->success) {
+		counters.parse_failures++;
+	}
+	return parsed;
+}
+
+shared_ptr<const ParsedQuery> CachedParser::DeserializeInternal(const char *data, idx_t size) {
+	if (max_query_bytes > 0 && size > max_query_bytes) {
+		return QueryBytesExceeded(size, max_query_bytes);
+	}
+	shared_ptr<const ParsedQuery> parsed = DeserializeParsedQuery(options, data, size);
+	if (max_nodes > 0 && parsed->success && ExceedsNodeBudget(*parsed)) {
+		return NodesExceeded(max_nodes);
+	}
+	return parsed;
+}
+
+// Extension scaffolding
+// ---------------------------------------------------
+
+void RegisterParseCacheSettings(ExtensionLoader &loader) {
+	auto &config = DBConfig::GetConfig(loader.GetDatabaseInstance());
+	config.AddExtensionOption(CACHE_ENABLED_SETTING,
+	                          "Cache parsed queries across parser_tools function calls",
+	                          LogicalType::BOOLEAN, Value::BOOLEAN(true));
+	config.AddExtensionOption(CACHE_SIZE_SETTING,
+	                          "Approximate capacity in bytes of the parser_tools parse cache",
+	                          LogicalType::UBIGINT, Value::UBIGINT(DEFAULT_CACHE_SIZE));
+	config.AddExtensionOption(PARALLEL_PARSE_SIZE_SETTING,
+	                          "Minimum size in bytes of a script to be split into statements and parsed in parallel "
+	                          "(0 to disable)",
+	                          LogicalType::UBIGINT, Value::UBIGINT(DEFAULT_PARALLEL_PARSE_SIZE));
+	config.AddExtensionOption(MAX_QUERY_BYTES_SETTING,
+	                          "Maximum size in bytes of a query to parse; larger queries are skipped (0 for no limit)",
+	                          LogicalType::UBIGINT, Value::UBIGINT(0));
+	config.AddExtensionOption(MAX_NODES_SETTING,
+	                          "Maximum number of nodes of a parsed query to extract from; larger queries are skipped "
+	                          "(0 for no limit)",
+	                          LogicalType::UBIGINT, Value::UBIGINT(0));
+	config.AddExtensionOption(PREFILTER_SETTING,
+	                          "Skip parsing queries that lexically cannot contain tables or function calls",
+	                          LogicalType::BOOLEAN, Value::BOOLEAN(true));
+}
+
+} // namespace duckdb
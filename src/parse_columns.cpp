@@ -0,0 +1,161 @@
+#include "parse_columns.hpp"
+#include "ast_collectors.hpp"
+#include "statement_cursor.hpp"
+#include "parse_cache.hpp"
+#include "parser_tools_state.hpp"
+#include "deduplicating_executor.hpp"
+#include "list_result_builder.hpp"
+#include "projected_columns.hpp"
+#include "context_enum.hpp"
+#include "duckdb.hpp"
+
+namespace duckdb {
+
+void ExtractColumnsFromStatements(const vector<unique_ptr<SQLStatement>> &statements, std::vector<ColumnResult> &results) {
+	ColumnCollector collector(results);
+	WalkStatements(statements, collector);
+}
+
+void ExtractColumnsFromStatement(const SQLStatement &statement, std::vector<ColumnResult> &results) {
+	ColumnCollector collector(results);
+	WalkStatement(statement, collector);
+}
+
+// Writes an optional name: empty names are NULL
+static void WriteName(Vector &vector, idx_t idx, const string_t &name) {
+	if (name.GetSize() == 0) {
+		FlatVector::SetNull(vector, idx, true);
+	} else {
+		FlatVector::GetData<string_t>(vector)[idx] = StringVector::AddStringOrBlob(vector, name);
+	}
+}
+
+// Table function
+// ---------------------------------------------------
+
+struct ParseColumnsState : public GlobalTableFunctionState {
+	bool initialized = false;
+	// created on the first call, and kept for the stats of the extraction
+	unique_ptr<CachedParser> parser;
+	// the results of the script, extracted one batch of statements at a time
+	StatementCursor<ColumnResult> cursor;
+	ProjectedColumns projection;
+};
+
+struct ParseColumnsBindData : public TableFunctionData {
+	string sql;
+	ParserOptions options;
+};
+
+static unique_ptr<FunctionData> ParseColumnsBind(ClientContext &context, TableFunctionBindInput &input,
+                                                 vector<LogicalType> &return_types, vector<string> &names) {
+	return_types = {LogicalType::VARCHAR, LogicalType::VARCHAR, FunctionContextType()};
+	names = {"table_name", "column_name", "context"};
+
+	auto result = make_uniq<ParseColumnsBindData>();
+	result->sql = StringValue::Get(input.inputs[0]);
+	result->options = context.GetParserOptions();
+	return std::move(result);
+}
+
+static unique_ptr<GlobalTableFunctionState> ParseColumnsInit(ClientContext &context, TableFunctionInitInput &input) {
+	auto state = make_uniq<ParseColumnsState>();
+	state->projection = ProjectedColumns(input.column_ids);
+	return std::move(state);
+}
+
+// Writes column `column_id` (table_name, column_name, context) of `count` results starting at `offset`.
+// Returns false for unknown column ids
+static bool WriteColumnColumn(column_t column_id, Vector &vector, const vector<ColumnResult> &results, idx_t offset,
+                              idx_t count) {
+	switch (column_id) {
+	case 0:
+		for (idx_t i = 0; i < count; i++) {
+			WriteName(vector, i, results[offset + i].table_name);
+		}
+		return true;
+	case 1:
+		for (idx_t i = 0; i < count; i++) {
+			WriteName(vector, i, results[offset + i].column_name);
+		}
+		return true;
+	case 2:
+		for (idx_t i = 0; i < count; i++) {
+			SetContext(vector, i, results[offset + i].context);
+		}
+		return true;
+	default:
+		return false;
+	}
+}
+
+static void ParseColumnsFunction(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+	auto &state = (ParseColumnsState &)*data.global_state;
+	auto &bind_data = (ParseColumnsBindData &)*data.bind_data;
+
+	if (!state.initialized) {
+		state.parser = make_uniq<CachedParser>(context, bind_data.options, "parse_columns");
+		state.cursor.Reset(state.parser->Parse(bind_data.sql), state.parser->Counters());
+		state.initialized = true;
+	}
+	auto &cursor = state.cursor;
+	if (!cursor.Next([](const SQLStatement &statement, vector<ColumnResult> &results) {
+		    ExtractColumnsFromStatement(statement, results);
+	    })) {
+		output.SetCardinality(0);
+		return;
+	}
+
+	auto count = cursor.ChunkSize();
+	state.projection.Write(output, cursor.row, count, state.parser->Counters(),
+	                       [&](column_t column_id, Vector &vector, idx_t offset, idx_t count) -> bool {
+		                       return WriteColumnColumn(column_id, vector, cursor.results, offset, count);
+	                       });
+	cursor.row += count;
+}
+
+// Scalar function
+// ---------------------------------------------------
+
+static void ParseColumnsScalarFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &parser = ParserToolsLocalState::Get(state).parser;
+	ListResultBuilder<ColumnResult> builder(result, parser.Counters());
+	DeduplicatingExecutor::ExecuteWithNulls<list_entry_t>(
+	    args.data[0], result, args.size(), [&builder, &parser](string_t query, bool &is_null) -> list_entry_t {
+		    auto parsed = parser.Parse(query);
+		    return builder.Append(parsed, is_null, [&](vector<ColumnResult> &columns) {
+			    ExtractColumnsFromStatements(parsed->statements, columns);
+		    });
+	    });
+
+	builder.Finalize([](Vector &struct_vector, idx_t offset, const vector<ColumnResult> &columns) {
+		auto &entries = StructVector::GetEntries(struct_vector);
+		for (idx_t i = 0; i < columns.size(); i++) {
+			WriteName(*entries[0], offset + i, columns[i].table_name);
+		}
+		auto column_data = FlatVector::GetData<string_t>(*entries[1]);
+		for (idx_t i = 0; i < columns.size(); i++) {
+			column_data[offset + i] = StringVector::AddStringOrBlob(*entries[1], columns[i].column_name);
+		}
+		for (idx_t i = 0; i < columns.size(); i++) {
+			SetContext(*entries[2], offset + i, columns[i].context);
+		}
+	});
+}
+
+// Extension scaffolding
+// ---------------------------------------------------
+
+void RegisterParseColumnsFunction(ExtensionLoader &loader) {
+	TableFunction tf("parse_columns", {LogicalType::VARCHAR}, ParseColumnsFunction, ParseColumnsBind, ParseColumnsInit);
+	tf.projection_pushdown = true;
+	loader.RegisterFunction(tf);
+
+	auto return_type = LogicalType::LIST(LogicalType::STRUCT({{"table_name", LogicalType::VARCHAR},
+	                                                          {"column_name", LogicalType::VARCHAR},
+	                                                          {"context", FunctionContextType()}}));
+	loader.RegisterFunction(
+	    ParserToolsScalarFunction("parse_columns", {LogicalType::VARCHAR}, return_type, ParseColumnsScalarFunction));
+}
+
+} // namespace duckdb
@@ -1,4 +1,14 @@
 #include "parse_functions.hpp"
+#include "ast_collectors.hpp"
+#include "parse_in_out.hpp"
+#include "parse_scan.hpp"
+#include "statement_cursor.hpp"
+#include "parse_cache.hpp"
+#include "parser_tools_state.hpp"
+#include "deduplicating_executor.hpp"
+#include "list_result_builder.hpp"
+#include "projected_columns.hpp"
+#include "context_enum.hpp"
 #include "duckdb.hpp"
 #include "duckdb/parser/parser.hpp"
 #include "duckdb/parser/statement/select_statement.hpp"
@@ -13,18 +23,7 @@
 
 namespace duckdb {
 
-enum class FunctionContext {
-	Select,
-	Where,
-	Having,
-	OrderBy,
-	GroupBy,
-	Join,
-	WindowFunction,
-	Nested
-};
-
-inline const char *ToString(FunctionContext context) {
+const char *ToString(FunctionContext context) {
 	switch (context) {
 		case FunctionContext::Select: return "select";
 		case FunctionContext::Where: return "where";
@@ -38,13 +37,22 @@ inline const char *ToString(FunctionContext context) {
 	}
 }
 
+LogicalType FunctionContextType() {
+	return CreateContextEnumType<FunctionContext>(static_cast<idx_t>(FunctionContext::Nested) + 1);
+}
+
 struct ParseFunctionsState : public GlobalTableFunctionState {
-	idx_t row = 0;
-	vector<FunctionResult> results;
+	bool initialized = false;
+	// created on the first call, and kept for the stats of the extraction
+	unique_ptr<CachedParser> parser;
+	// the results of the script, extracted one batch of statements at a time
+	StatementCursor<FunctionResult> cursor;
+	ProjectedColumns projection;
 };
 
 struct ParseFunctionsBindData : public TableFunctionData {
 	string sql;
+	ParserOptions options;
 };
 
 // BIND function: runs during query planning to decide output schema
@@ -56,13 +64,14 @@ static unique_ptr<FunctionData> ParseFunctionsBind(ClientContext &context,
 	string sql_input = StringValue::Get(input.inputs[0]);
 
 	// always return the same columns:
-	return_types = {LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::VARCHAR};
+	return_types = {LogicalType::VARCHAR, LogicalType::VARCHAR, FunctionContextType()};
 	// function name, schema name, usage context
 	names = {"function_name", "schema", "context"};
 
 	// create a bind data object to hold the SQL input
 	auto result = make_uniq<ParseFunctionsBindData>();
 	result->sql = sql_input;
+	result->options = context.GetParserOptions();
 
 	return std::move(result);
 }
@@ -70,165 +79,43 @@ static unique_ptr<FunctionData> ParseFunctionsBind(ClientContext &context,
 // INIT function: runs before table function execution
 static unique_ptr<GlobalTableFunctionState> ParseFunctionsInit(ClientContext &context,
 																														TableFunctionInitInput &input) {
-	return make_uniq<ParseFunctionsState>();
+	auto state = make_uniq<ParseFunctionsState>();
+	state->projection = ProjectedColumns(input.column_ids);
+	return std::move(state);
 }
 
-class FunctionExtractor {
-public:
-	static void ExtractFromExpression(const ParsedExpression &expr, 
-																					std::vector<FunctionResult> &results,
-																					FunctionContext context = FunctionContext::Select) {
-		if (expr.expression_class == ExpressionClass::FUNCTION) {
-			auto &func = (FunctionExpression &)expr;
-			results.push_back(FunctionResult{
-				func.function_name,
-				func.schema.empty() ? "main" : func.schema,
-				ToString(context)
-			});
-			
-			// For nested function calls within this function, mark as nested
-			ParsedExpressionIterator::EnumerateChildren(expr, [&](const ParsedExpression &child) {
-				ExtractFromExpression(child, results, FunctionContext::Nested);
-			});
-		} else if (expr.expression_class == ExpressionClass::WINDOW) {
-			auto &window_expr = (WindowExpression &)expr;
-			results.push_back(FunctionResult{
-				window_expr.function_name,
-				window_expr.schema.empty() ? "main" : window_expr.schema,
-				ToString(context)
-			});
-			
-			// Extract functions from window function arguments
-			for (const auto &child : window_expr.children) {
-				if (child) {
-					ExtractFromExpression(*child, results, FunctionContext::Nested);
-				}
-			}
-			
-			// Extract functions from PARTITION BY expressions
-			for (const auto &partition : window_expr.partitions) {
-				if (partition) {
-					ExtractFromExpression(*partition, results, FunctionContext::Nested);
-				}
-			}
-			
-			// Extract functions from ORDER BY expressions
-			for (const auto &order : window_expr.orders) {
-				if (order.expression) {
-					ExtractFromExpression(*order.expression, results, FunctionContext::Nested);
-				}
-			}
-			
-			// Extract functions from argument ordering expressions
-			for (const auto &arg_order : window_expr.arg_orders) {
-				if (arg_order.expression) {
-					ExtractFromExpression(*arg_order.expression, results, FunctionContext::Nested);
-				}
-			}
-			
-			// Extract functions from frame expressions
-			if (window_expr.start_expr) {
-				ExtractFromExpression(*window_expr.start_expr, results, FunctionContext::Nested);
-			}
-			if (window_expr.end_expr) {
-				ExtractFromExpression(*window_expr.end_expr, results, FunctionContext::Nested);
-			}
-			if (window_expr.offset_expr) {
-				ExtractFromExpression(*window_expr.offset_expr, results, FunctionContext::Nested);
-			}
-			if (window_expr.default_expr) {
-				ExtractFromExpression(*window_expr.default_expr, results, FunctionContext::Nested);
-			}
-			
-			// Extract functions from filter expression
-			if (window_expr.filter_expr) {
-				ExtractFromExpression(*window_expr.filter_expr, results, FunctionContext::Nested);
-			}
-		} else {
-			// For non-function expressions, preserve the current context
-			ParsedExpressionIterator::EnumerateChildren(expr, [&](const ParsedExpression &child) {
-				ExtractFromExpression(child, results, context);
-			});
-		}
-	}
-
-	static void ExtractFromExpressionList(const vector<unique_ptr<ParsedExpression>> &expressions,
-																								std::vector<FunctionResult> &results,
-																								FunctionContext context) {
-		for (const auto &expr : expressions) {
-			if (expr) {
-				ExtractFromExpression(*expr, results, context);
-			}
-		}
-	}
-};
-
+void ExtractFunctionsFromStatements(const vector<unique_ptr<SQLStatement>> &statements, std::vector<FunctionResult> &results) {
+	FunctionCollector collector(results);
+	WalkStatements(statements, collector);
+}
 
-static void ExtractFunctionsFromQueryNode(const QueryNode &node, std::vector<FunctionResult> &results) {
-	if (node.type == QueryNodeType::SELECT_NODE) {
-		auto &select_node = (SelectNode &)node;
+void ExtractFunctionsFromStatement(const SQLStatement &statement, std::vector<FunctionResult> &results) {
+	FunctionCollector collector(results);
+	WalkStatement(statement, collector);
+}
 
-		// Extract from CTEs first (to match expected order in tests)
-		for (const auto &cte : select_node.cte_map.map) {
-			if (cte.second && cte.second->query && cte.second->query->node) {
-				ExtractFunctionsFromQueryNode(*cte.second->query->node, results);
+// Writes column `column_id` (function_name, schema, context) of `count` results starting at `offset`.
+// Returns false for unknown column ids
+static bool WriteFunctionColumn(column_t column_id, Vector &vector, const vector<FunctionResult> &results, idx_t offset, idx_t count) {
+	auto data = FlatVector::GetData<string_t>(vector);
+	switch (column_id) {
+		case 0:
+			for (idx_t i = 0; i < count; i++) {
+				data[i] = StringVector::AddString(vector, results[offset + i].function_name);
 			}
-		}
-
-		// Extract from SELECT list
-		FunctionExtractor::ExtractFromExpressionList(select_node.select_list, results, FunctionContext::Select);
-
-		// Extract from WHERE clause
-		if (select_node.where_clause) {
-			FunctionExtractor::ExtractFromExpression(*select_node.where_clause, results, FunctionContext::Where);
-		}
-
-		// Extract from GROUP BY clause
-		FunctionExtractor::ExtractFromExpressionList(select_node.groups.group_expressions, results, FunctionContext::GroupBy);
-
-		// Extract from HAVING clause
-		if (select_node.having) {
-			FunctionExtractor::ExtractFromExpression(*select_node.having, results, FunctionContext::Having);
-		}
-
-		// Extract from ORDER BY clause
-		for (const auto &modifier : select_node.modifiers) {
-			if (modifier->type == ResultModifierType::ORDER_MODIFIER) {
-				auto &order_modifier = (OrderModifier &)*modifier;
-				for (const auto &order : order_modifier.orders) {
-					if (order.expression) {
-						FunctionExtractor::ExtractFromExpression(*order.expression, results, FunctionContext::OrderBy);
-					}
-				}
+			return true;
+		case 1:
+			for (idx_t i = 0; i < count; i++) {
+				data[i] = StringVector::AddString(vector, results[offset + i].schema);
 			}
-		}
-	// additional step necessary for duckdb v1.4.0: unwrap CTE node
-	}  else if (node.type == QueryNodeType::CTE_NODE) {
-        auto &cte_node = (CTENode &)node;
-
-        if (cte_node.child) {
-            ExtractFunctionsFromQueryNode(*cte_node.child, results);
-        }
-    }
-}
-
-static void ExtractFunctionsFromSQL(const std::string &sql, std::vector<FunctionResult> &results) {
-	Parser parser;
-
-	try {
-		parser.ParseQuery(sql);
-	} catch (const ParserException &ex) {
-		// swallow parser exceptions to make this function more robust. is_parsable can be used if needed
-		return;
-	}
-
-	for (auto &stmt : parser.statements) {
-		if (stmt->type == StatementType::SELECT_STATEMENT) {
-			auto &select_stmt = (SelectStatement &)*stmt;
-			if (select_stmt.node) {
-				ExtractFunctionsFromQueryNode(*select_stmt.node, results);
+			return true;
+		case 2:
+			for (idx_t i = 0; i < count; i++) {
+				SetContext(vector, i, results[offset + i].context);
 			}
-		}
+			return true;
+		default:
+			return false;
 	}
 }
 
@@ -238,97 +125,127 @@ static void ParseFunctionsFunction(ClientContext &context,
 	auto &state = (ParseFunctionsState &)*data.global_state;
 	auto &bind_data = (ParseFunctionsBindData &)*data.bind_data;
 
-	if (state.results.empty() && state.row == 0) {
-		ExtractFunctionsFromSQL(bind_data.sql, state.results);
+	if (!state.initialized) {
+		state.parser = make_uniq<CachedParser>(context, bind_data.options, "parse_functions");
+		state.cursor.Reset(state.parser->Parse(bind_data.sql, ParseTarget::Functions), state.parser->Counters());
+		state.initialized = true;
 	}
-
-	if (state.row >= state.results.size()) {
+	auto &cursor = state.cursor;
+	if (!cursor.Next([](const SQLStatement &statement, vector<FunctionResult> &results) {
+		    ExtractFunctionsFromStatement(statement, results);
+	    })) {
+		output.SetCardinality(0);
 		return;
 	}
 
-	auto &func = state.results[state.row];
-	output.SetCardinality(1);
-	output.SetValue(0, 0, Value(func.function_name));
-	output.SetValue(1, 0, Value(func.schema));
-	output.SetValue(2, 0, Value(func.context));
-
-	state.row++;
+	// fill the chunk up to STANDARD_VECTOR_SIZE, writing only the projected columns
+	auto count = cursor.ChunkSize();
+	state.projection.Write(output, cursor.row, count, state.parser->Counters(), [&](column_t column_id, Vector &vector, idx_t offset, idx_t count) -> bool {
+		return WriteFunctionColumn(column_id, vector, cursor.results, offset, count);
+	});
+	cursor.row += count;
 }
 
-static void ParseFunctionNamesScalarFunction(DataChunk &args, ExpressionState &state, Vector &result) {
-	UnaryExecutor::Execute<string_t, list_entry_t>(args.data[0], result, args.size(),
-	[&result](string_t query) -> list_entry_t {
-		// Parse the SQL query and extract function names
-		auto query_string = query.GetString();
-		std::vector<FunctionResult> parsed_functions;
-		ExtractFunctionsFromSQL(query_string, parsed_functions);
+// In-out variant: parse_functions_lateral(sql) consumes a column of queries and streams
+// (row_id, function_name, schema, context) rows
+static unique_ptr<FunctionData> ParseFunctionsInOutBind(ClientContext &context,
+													TableFunctionBindInput &input,
+													vector<LogicalType> &return_types,
+													vector<string> &names) {
+	return_types = {LogicalType::BIGINT, LogicalType::VARCHAR, LogicalType::VARCHAR, FunctionContextType()};
+	names = {"row_id", "function_name", "schema", "context"};
+	return make_uniq<ParseInOutBindData>(input.table_function.name, context.GetParserOptions(), ParseTarget::Functions);
+}
 
-		auto current_size = ListVector::GetListSize(result);
-		auto number_of_functions = parsed_functions.size();
-		auto new_size = current_size + number_of_functions;
+static OperatorResultType ParseFunctionsInOutFunction(ExecutionContext &context,
+												TableFunctionInput &data,
+												DataChunk &input,
+												DataChunk &output) {
+	return ParseInOutExecute<FunctionResult>(context, data, input, output,
+	[](const ParsedQuery &parsed, std::vector<FunctionResult> &results) {
+		ExtractFunctionsFromStatements(parsed.statements, results);
+	},
+	[](DataChunk &output, idx_t idx, const FunctionResult &func) {
+		FlatVector::GetData<string_t>(output.data[1])[idx] = StringVector::AddString(output.data[1], func.function_name);
+		FlatVector::GetData<string_t>(output.data[2])[idx] = StringVector::AddString(output.data[2], func.schema);
+		SetContext(output.data[3], idx, func.context);
+	});
+}
 
-		// grow list if needed
-		if (ListVector::GetListCapacity(result) < new_size) {
-			ListVector::Reserve(result, new_size);
-		}
+// File scan variant: parse_functions_scan('queries/**/*.sql') parses every matching file on the worker threads and
+// streams (filename, function_name, schema, context) rows
+static unique_ptr<FunctionData> ParseFunctionsScanBind(ClientContext &context,
+													TableFunctionBindInput &input,
+													vector<LogicalType> &return_types,
+													vector<string> &names) {
+	return_types = {LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::VARCHAR, FunctionContextType()};
+	names = {"filename", "function_name", "schema", "context"};
+	auto files = GlobQueryFiles(context, StringValue::Get(input.inputs[0]));
+	return make_uniq<ParseScanBindData>(input.table_function.name, std::move(files), context.GetParserOptions(), ParseTarget::Functions);
+}
 
-		// Write the function names into the child vector
-		auto functions = FlatVector::GetData<string_t>(ListVector::GetEntry(result));
-		for (size_t i = 0; i < parsed_functions.size(); i++) {
-			auto &func = parsed_functions[i];
-			functions[current_size + i] = StringVector::AddStringOrBlob(ListVector::GetEntry(result), func.function_name);
-		}
+static void ParseFunctionsScanFunction(ClientContext &context,
+									   TableFunctionInput &data,
+									   DataChunk &output) {
+	ParseScanExecute<FunctionResult>(context, data, output,
+	[](const SQLStatement &statement, const string &contents, vector<FunctionResult> &results) {
+		ExtractFunctionsFromStatement(statement, results);
+	}, WriteFunctionColumn);
+}
 
-		// Update size
-		ListVector::SetListSize(result, new_size);
+static void ParseFunctionNamesScalarFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &parser = ParserToolsLocalState::Get(state).parser;
+	auto serialized = IsSerializedArgument(args.data[0]);
+	ListResultBuilder<FunctionResult> builder(result, parser.Counters());
+	DeduplicatingExecutor::ExecuteWithNulls<list_entry_t>(args.data[0], result, args.size(),
+	[&builder, &parser, serialized](string_t query, bool &is_null) -> list_entry_t {
+		// Parse the SQL query and extract function names
+		auto parsed = parser.ParseArgument(query, serialized, ParseTarget::Functions);
+		return builder.Append(parsed, is_null, [&](std::vector<FunctionResult> &functions) {
+			ExtractFunctionsFromStatements(parsed->statements, functions);
+		});
+	});
 
-		return list_entry_t(current_size, number_of_functions);
+	// Write the function names of the whole chunk into the child vector
+	builder.Finalize([](Vector &child, idx_t offset, const std::vector<FunctionResult> &functions) {
+		auto function_name_data = FlatVector::GetData<string_t>(child);
+		for (idx_t i = 0; i < functions.size(); i++) {
+			function_name_data[offset + i] = StringVector::AddStringOrBlob(child, functions[i].function_name);
+		}
 	});
 }
 
 static void ParseFunctionsScalarFunction_struct(DataChunk &args, ExpressionState &state, Vector &result) {
-	UnaryExecutor::Execute<string_t, list_entry_t>(args.data[0], result, args.size(),
-	[&result](string_t query) -> list_entry_t {
+	auto &parser = ParserToolsLocalState::Get(state).parser;
+	auto serialized = IsSerializedArgument(args.data[0]);
+	ListResultBuilder<FunctionResult> builder(result, parser.Counters());
+	DeduplicatingExecutor::ExecuteWithNulls<list_entry_t>(args.data[0], result, args.size(),
+	[&builder, &parser, serialized](string_t query, bool &is_null) -> list_entry_t {
 		// Parse the SQL query and extract function names
-		auto query_string = query.GetString();
-		std::vector<FunctionResult> parsed_functions;
-		ExtractFunctionsFromSQL(query_string, parsed_functions);
-
-		auto current_size = ListVector::GetListSize(result);
-		auto number_of_functions = parsed_functions.size();
-		auto new_size = current_size + number_of_functions;
-
-		// Grow list vector if needed
-		if (ListVector::GetListCapacity(result) < new_size) {
-			ListVector::Reserve(result, new_size);
-		}
-
-		// Get the struct child vector of the list
-		auto &struct_vector = ListVector::GetEntry(result);
-
-		// Ensure list size is updated
-		ListVector::SetListSize(result, new_size);
+		auto parsed = parser.ParseArgument(query, serialized, ParseTarget::Functions);
+		return builder.Append(parsed, is_null, [&](std::vector<FunctionResult> &functions) {
+			ExtractFunctionsFromStatements(parsed->statements, functions);
+		});
+	});
 
-		// Get the fields in the STRUCT
+	builder.Finalize([](Vector &struct_vector, idx_t offset, const std::vector<FunctionResult> &functions) {
+		// Get the fields in the STRUCT and fill them one at a time
 		auto &entries = StructVector::GetEntries(struct_vector);
 		auto &function_name_entry = *entries[0]; // "function_name" field
 		auto &schema_entry = *entries[1];  // "schema" field
 		auto &context_entry = *entries[2]; // "context" field
 
 		auto function_name_data = FlatVector::GetData<string_t>(function_name_entry);
+		for (idx_t i = 0; i < functions.size(); i++) {
+			function_name_data[offset + i] = StringVector::AddStringOrBlob(function_name_entry, functions[i].function_name);
+		}
 		auto schema_data = FlatVector::GetData<string_t>(schema_entry);
-		auto context_data = FlatVector::GetData<string_t>(context_entry);
-
-		for (size_t i = 0; i < number_of_functions; i++) {
-			const auto &func = parsed_functions[i];
-			auto idx = current_size + i;
-
-			function_name_data[idx] = StringVector::AddStringOrBlob(function_name_entry, func.function_name);
-			schema_data[idx] = StringVector::AddStringOrBlob(schema_entry, func.schema);
-			context_data[idx] = StringVector::AddStringOrBlob(context_entry, func.context);
+		for (idx_t i = 0; i < functions.size(); i++) {
+			schema_data[offset + i] = StringVector::AddStringOrBlob(schema_entry, functions[i].schema);
+		}
+		for (idx_t i = 0; i < functions.size(); i++) {
+			SetContext(context_entry, offset + i, functions[i].context);
 		}
-
-		return list_entry_t(current_size, number_of_functions);
 	});
 }
 
@@ -337,22 +254,38 @@ static void ParseFunctionsScalarFunction_struct(DataChunk &args, ExpressionState
 
 void RegisterParseFunctionsFunction(ExtensionLoader &loader) {
 	TableFunction tf("parse_functions", {LogicalType::VARCHAR}, ParseFunctionsFunction, ParseFunctionsBind, ParseFunctionsInit);
+	tf.projection_pushdown = true;
 	loader.RegisterFunction(tf);
+
+	// parse_functions_lateral is an in-out function that streams the functions of a column of queries
+	TableFunction in_out("parse_functions_lateral", {LogicalType::VARCHAR}, nullptr, ParseFunctionsInOutBind, ParseInOutInitGlobal, ParseInOutInitLocal<FunctionResult>);
+	in_out.in_out_function = ParseFunctionsInOutFunction;
+	loader.RegisterFunction(in_out);
+
+	// parse_functions_scan(glob) reads and parses files in parallel, one file per thread at a time
+	TableFunction scan("parse_functions_scan", {LogicalType::VARCHAR}, ParseFunctionsScanFunction, ParseFunctionsScanBind, ParseScanInitGlobal, ParseScanInitLocal<FunctionResult>);
+	scan.projection_pushdown = true;
+	loader.RegisterFunction(scan);
 }
 
 void RegisterParseFunctionScalarFunction(ExtensionLoader &loader) {
 	// parse_function_names is a scalar function that returns a list of function names
-	ScalarFunction sf("parse_function_names", {LogicalType::VARCHAR}, LogicalType::LIST(LogicalType::VARCHAR), ParseFunctionNamesScalarFunction);
-	loader.RegisterFunction(sf);
+	// the BLOB overloads take queries persisted with parse_to_blob
+	ScalarFunctionSet set("parse_function_names");
+	set.AddFunction(ParserToolsScalarFunction("parse_function_names", {LogicalType::VARCHAR}, LogicalType::LIST(LogicalType::VARCHAR), ParseFunctionNamesScalarFunction));
+	set.AddFunction(ParserToolsScalarFunction("parse_function_names", {LogicalType::BLOB}, LogicalType::LIST(LogicalType::VARCHAR), ParseFunctionNamesScalarFunction));
+	loader.RegisterFunction(set);
 
 	// parse_functions_struct is a scalar function that returns a list of structs
 	auto return_type = LogicalType::LIST(LogicalType::STRUCT({
 		{"function_name", LogicalType::VARCHAR},
 		{"schema", LogicalType::VARCHAR},
-		{"context", LogicalType::VARCHAR}
+		{"context", FunctionContextType()}
 	}));
-	ScalarFunction sf_struct("parse_functions", {LogicalType::VARCHAR}, return_type, ParseFunctionsScalarFunction_struct);
-	loader.RegisterFunction(sf_struct);
+	ScalarFunctionSet struct_set("parse_functions");
+	struct_set.AddFunction(ParserToolsScalarFunction("parse_functions", {LogicalType::VARCHAR}, return_type, ParseFunctionsScalarFunction_struct));
+	struct_set.AddFunction(ParserToolsScalarFunction("parse_functions", {LogicalType::BLOB}, return_type, ParseFunctionsScalarFunction_struct));
+	loader.RegisterFunction(struct_set);
 }
 
 
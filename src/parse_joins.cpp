@@ -0,0 +1,388 @@
+#include "parse_joins.hpp"
+#include "ast_collectors.hpp"
+#include "statement_cursor.hpp"
+#include "parse_cache.hpp"
+#include "parser_tools_state.hpp"
+#include "deduplicating_executor.hpp"
+#include "list_result_builder.hpp"
+#include "projected_columns.hpp"
+#include "duckdb.hpp"
+#include "duckdb/common/enum_util.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/parser/expression/columnref_expression.hpp"
+#include "duckdb/parser/expression/comparison_expression.hpp"
+#include "duckdb/parser/expression/conjunction_expression.hpp"
+#include "duckdb/parser/tableref/basetableref.hpp"
+
+namespace duckdb {
+
+// Extraction
+// ---------------------------------------------------
+
+namespace {
+
+// A leaf of one side of a join: a base table, subquery or table function
+struct JoinSource {
+	string table;
+	string alias;
+	// the name its columns are qualified with
+	string name;
+};
+
+class JoinEdgeExtractor {
+public:
+	JoinEdgeExtractor(const JoinRef &join_p, std::vector<JoinResult> &results_p) : join(join_p), results(results_p) {
+		CollectSources(*join.left, left_sources);
+		CollectSources(*join.right, right_sources);
+	}
+
+	void Extract() {
+		auto join_type = JoinTypeName();
+		edges_start = results.size();
+		if (!join.using_columns.empty()) {
+			// USING (a, b): the columns of the same name; the sides are only known if they are single sources
+			auto &edge = AddEdge(SingleSource(left_sources), SingleSource(right_sources), join_type);
+			edge.left_keys = join.using_columns;
+			edge.right_keys = join.using_columns;
+			return;
+		}
+		if (join.condition) {
+			ExtractEquiKeys(*join.condition, join_type);
+		}
+		if (results.size() == edges_start) {
+			// no equi-join keys: a single edge between the sides
+			AddEdge(SingleSource(left_sources), SingleSource(right_sources), join_type);
+		}
+	}
+
+private:
+	static void CollectSources(const TableRef &root, vector<JoinSource> &sources) {
+		vector<const TableRef *> pending {&root};
+		while (!pending.empty()) {
+			auto &ref = *pending.back();
+			pending.pop_back();
+			if (ref.type == TableReferenceType::JOIN) {
+				auto &join = (JoinRef &)ref;
+				pending.push_back(join.right.get());
+				pending.push_back(join.left.get());
+				continue;
+			}
+			JoinSource source;
+			source.alias = ref.alias;
+			if (ref.type == TableReferenceType::BASE_TABLE) {
+				source.table = ((BaseTableRef &)ref).table_name;
+			}
+			source.name = source.alias.empty() ? source.table : source.alias;
+			sources.push_back(std::move(source));
+		}
+	}
+
+	static const JoinSource *SingleSource(const vector<JoinSource> &sources) {
+		return sources.size() == 1 ? &sources[0] : nullptr;
+	}
+
+	// The source of `sources` the column is qualified with
+	static const JoinSource *FindSource(const vector<JoinSource> &sources, const ColumnRefExpression &column) {
+		if (column.column_names.size() < 2) {
+			// unqualified: only unambiguous if this side is a single source
+			return nullptr;
+		}
+		auto &qualifier = column.column_names[column.column_names.size() - 2];
+		for (auto &source : sources) {
+			if (!source.name.empty() && StringUtil::CIEquals(source.name, qualifier)) {
+				return &source;
+			}
+		}
+		return nullptr;
+	}
+
+	string JoinTypeName() const {
+		switch (join.ref_type) {
+		case JoinRefType::CROSS:
+			return "cross";
+		case JoinRefType::POSITIONAL:
+			return "positional";
+		default:
+			break;
+		}
+		string name;
+		switch (join.type) {
+		case JoinType::INNER:
+			name = "inner";
+			break;
+		case JoinType::OUTER:
+			name = "full";
+			break;
+		default:
+			name = StringUtil::Lower(EnumUtil::ToString(join.type));
+			break;
+		}
+		if (join.ref_type == JoinRefType::NATURAL) {
+			return "natural " + name;
+		}
+		if (join.ref_type == JoinRefType::ASOF) {
+			return "asof " + name;
+		}
+		return name;
+	}
+
+	JoinResult &AddEdge(const JoinSource *left, const JoinSource *right, const string &join_type) {
+		JoinResult result;
+		if (left) {
+			result.left_table = left->table;
+			result.left_alias = left->alias;
+		}
+		if (right) {
+			result.right_table = right->table;
+			result.right_alias = right->alias;
+		}
+		result.join_type = join_type;
+		results.push_back(std::move(result));
+		edge_sources.emplace_back(left, right);
+		return results.back();
+	}
+
+	// The equalities of columns of both sides among the conjuncts of the ON condition, grouped by pair of sources
+	void ExtractEquiKeys(const ParsedExpression &condition, const string &join_type) {
+		vector<const ParsedExpression *> pending {&condition};
+		while (!pending.empty()) {
+			auto &expr = *pending.back();
+			pending.pop_back();
+			if (expr.type == ExpressionType::CONJUNCTION_AND) {
+				auto &conjunction = (ConjunctionExpression &)expr;
+				for (idx_t i = conjunction.children.size(); i > 0; i--) {
+					pending.push_back(conjunction.children[i - 1].get());
+				}
+				continue;
+			}
+			if (expr.type != ExpressionType::COMPARE_EQUAL && expr.type != ExpressionType::COMPARE_NOT_DISTINCT_FROM) {
+				continue;
+			}
+			auto &comparison = (ComparisonExpression &)expr;
+			if (comparison.left->GetExpressionClass() != ExpressionClass::COLUMN_REF ||
+			    comparison.right->GetExpressionClass() != ExpressionClass::COLUMN_REF) {
+				continue;
+			}
+			auto *left_column = &(ColumnRefExpression &)*comparison.left;
+			auto *right_column = &(ColumnRefExpression &)*comparison.right;
+			auto left = FindSource(left_sources, *left_column);
+			auto right = FindSource(right_sources, *right_column);
+			if (!left || !right) {
+				// written the other way around: b.x = a.x
+				std::swap(left_column, right_column);
+				left = FindSource(left_sources, *left_column);
+				right = FindSource(right_sources, *right_column);
+			}
+			if (!left || !right) {
+				continue;
+			}
+			auto &edge = GetEdge(left, right, join_type);
+			edge.left_keys.push_back(left_column->GetColumnName());
+			edge.right_keys.push_back(right_column->GetColumnName());
+		}
+	}
+
+	JoinResult &GetEdge(const JoinSource *left, const JoinSource *right, const string &join_type) {
+		for (idx_t i = 0; i < edge_sources.size(); i++) {
+			if (edge_sources[i].first == left && edge_sources[i].second == right) {
+				return results[edges_start + i];
+			}
+		}
+		return AddEdge(left, right, join_type);
+	}
+
+	const JoinRef &join;
+	std::vector<JoinResult> &results;
+	vector<JoinSource> left_sources;
+	vector<JoinSource> right_sources;
+	// the edges of this join are results[edges_start...], between these sources
+	idx_t edges_start = 0;
+	vector<std::pair<const JoinSource *, const JoinSource *>> edge_sources;
+};
+
+} // namespace
+
+void ExtractJoinEdges(const JoinRef &join, std::vector<JoinResult> &results) {
+	JoinEdgeExtractor extractor(join, results);
+	extractor.Extract();
+}
+
+void ExtractJoinsFromStatements(const vector<unique_ptr<SQLStatement>> &statements, std::vector<JoinResult> &results) {
+	JoinCollector collector(results);
+	WalkStatements(statements, collector);
+}
+
+void ExtractJoinsFromStatement(const SQLStatement &statement, std::vector<JoinResult> &results) {
+	JoinCollector collector(results);
+	WalkStatement(statement, collector);
+}
+
+// Writes an optional name: empty names are NULL
+static void WriteName(Vector &vector, idx_t idx, const string &name) {
+	if (name.empty()) {
+		FlatVector::SetNull(vector, idx, true);
+	} else {
+		FlatVector::GetData<string_t>(vector)[idx] = StringVector::AddStringOrBlob(vector, name);
+	}
+}
+
+// Appends the keys to the child of a VARCHAR list vector and points row `idx` at them
+static void WriteKeys(Vector &list_vector, idx_t idx, const vector<string> &keys) {
+	auto offset = ListVector::GetListSize(list_vector);
+	ListVector::Reserve(list_vector, offset + keys.size());
+	auto &child = ListVector::GetEntry(list_vector);
+	auto child_data = FlatVector::GetData<string_t>(child);
+	for (idx_t i = 0; i < keys.size(); i++) {
+		child_data[offset + i] = StringVector::AddStringOrBlob(child, keys[i]);
+	}
+	ListVector::SetListSize(list_vector, offset + keys.size());
+	FlatVector::GetData<list_entry_t>(list_vector)[idx] = list_entry_t(offset, keys.size());
+}
+
+// Writes field `column_id` (left_table, left_alias, right_table, right_alias, join_type, left_keys, right_keys)
+// of result `result` at `idx`. Returns false for unknown column ids
+static bool WriteJoinField(column_t column_id, Vector &vector, idx_t idx, const JoinResult &result) {
+	switch (column_id) {
+	case 0:
+		WriteName(vector, idx, result.left_table);
+		return true;
+	case 1:
+		WriteName(vector, idx, result.left_alias);
+		return true;
+	case 2:
+		WriteName(vector, idx, result.right_table);
+		return true;
+	case 3:
+		WriteName(vector, idx, result.right_alias);
+		return true;
+	case 4:
+		WriteName(vector, idx, result.join_type);
+		return true;
+	case 5:
+		WriteKeys(vector, idx, result.left_keys);
+		return true;
+	case 6:
+		WriteKeys(vector, idx, result.right_keys);
+		return true;
+	default:
+		return false;
+	}
+}
+
+static const idx_t JOIN_FIELD_COUNT = 7;
+
+static child_list_t<LogicalType> JoinFields() {
+	return {{"left_table", LogicalType::VARCHAR},
+	        {"left_alias", LogicalType::VARCHAR},
+	        {"right_table", LogicalType::VARCHAR},
+	        {"right_alias", LogicalType::VARCHAR},
+	        {"join_type", LogicalType::VARCHAR},
+	        {"left_keys", LogicalType::LIST(LogicalType::VARCHAR)},
+	        {"right_keys", LogicalType::LIST(LogicalType::VARCHAR)}};
+}
+
+// Table function
+// ---------------------------------------------------
+
+struct ParseJoinsState : public GlobalTableFunctionState {
+	bool initialized = false;
+	// created on the first call, and kept for the stats of the extraction
+	unique_ptr<CachedParser> parser;
+	// the results of the script, extracted one batch of statements at a time
+	StatementCursor<JoinResult> cursor;
+	ProjectedColumns projection;
+};
+
+struct ParseJoinsBindData : public TableFunctionData {
+	string sql;
+	ParserOptions options;
+};
+
+static unique_ptr<FunctionData> ParseJoinsBind(ClientContext &context, TableFunctionBindInput &input,
+                                               vector<LogicalType> &return_types, vector<string> &names) {
+	for (auto &field : JoinFields()) {
+		names.push_back(field.first);
+		return_types.push_back(field.second);
+	}
+
+	auto result = make_uniq<ParseJoinsBindData>();
+	result->sql = StringValue::Get(input.inputs[0]);
+	result->options = context.GetParserOptions();
+	return std::move(result);
+}
+
+static unique_ptr<GlobalTableFunctionState> ParseJoinsInit(ClientContext &context, TableFunctionInitInput &input) {
+	auto state = make_uniq<ParseJoinsState>();
+	state->projection = ProjectedColumns(input.column_ids);
+	return std::move(state);
+}
+
+static void ParseJoinsFunction(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+	auto &state = (ParseJoinsState &)*data.global_state;
+	auto &bind_data = (ParseJoinsBindData &)*data.bind_data;
+
+	if (!state.initialized) {
+		state.parser = make_uniq<CachedParser>(context, bind_data.options, "parse_joins");
+		state.cursor.Reset(state.parser->Parse(bind_data.sql, ParseTarget::Tables), state.parser->Counters());
+		state.initialized = true;
+	}
+	auto &cursor = state.cursor;
+	if (!cursor.Next([](const SQLStatement &statement, vector<JoinResult> &results) {
+		    ExtractJoinsFromStatement(statement, results);
+	    })) {
+		output.SetCardinality(0);
+		return;
+	}
+
+	auto count = cursor.ChunkSize();
+	state.projection.Write(output, cursor.row, count, state.parser->Counters(),
+	                       [&](column_t column_id, Vector &vector, idx_t offset, idx_t count) -> bool {
+		                       if (column_id >= JOIN_FIELD_COUNT) {
+			                       return false;
+		                       }
+		                       for (idx_t i = 0; i < count; i++) {
+			                       WriteJoinField(column_id, vector, i, cursor.results[offset + i]);
+		                       }
+		                       return true;
+	                       });
+	cursor.row += count;
+}
+
+// Scalar function
+// ---------------------------------------------------
+
+static void ParseJoinsScalarFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &parser = ParserToolsLocalState::Get(state).parser;
+	ListResultBuilder<JoinResult> builder(result, parser.Counters());
+	DeduplicatingExecutor::ExecuteWithNulls<list_entry_t>(
+	    args.data[0], result, args.size(), [&builder, &parser](string_t query, bool &is_null) -> list_entry_t {
+		    auto parsed = parser.Parse(query, ParseTarget::Tables);
+		    return builder.Append(parsed, is_null, [&](vector<JoinResult> &joins) {
+			    ExtractJoinsFromStatements(parsed->statements, joins);
+		    });
+	    });
+
+	builder.Finalize([](Vector &struct_vector, idx_t offset, const vector<JoinResult> &joins) {
+		auto &entries = StructVector::GetEntries(struct_vector);
+		for (idx_t field = 0; field < JOIN_FIELD_COUNT; field++) {
+			for (idx_t i = 0; i < joins.size(); i++) {
+				WriteJoinField(field, *entries[field], offset + i, joins[i]);
+			}
+		}
+	});
+}
+
+// Extension scaffolding
+// ---------------------------------------------------
+
+void RegisterParseJoinsFunction(ExtensionLoader &loader) {
+	TableFunction tf("parse_joins", {LogicalType::VARCHAR}, ParseJoinsFunction, ParseJoinsBind, ParseJoinsInit);
+	tf.projection_pushdown = true;
+	loader.RegisterFunction(tf);
+
+	auto return_type = LogicalType::LIST(LogicalType::STRUCT(JoinFields()));
+	loader.RegisterFunction(
+	    ParserToolsScalarFunction("parse_joins", {LogicalType::VARCHAR}, return_type, ParseJoinsScalarFunction));
+}
+
+} // namespace duckdb
@@ -1,4 +1,10 @@
 #include "parse_statements.hpp"
+#include "parse_cache.hpp"
+#include "parser_tools_state.hpp"
+#include "deduplicating_executor.hpp"
+#include "list_result_builder.hpp"
+#include "parse_scan.hpp"
+#include "statement_cursor.hpp"
 #include "duckdb.hpp"
 #include "duckdb/parser/parser.hpp"
 #include "duckdb/parser/statement/select_statement.hpp"
@@ -7,12 +13,18 @@
 namespace duckdb {
 
 struct ParseStatementsState : public GlobalTableFunctionState {
-	idx_t row = 0;
-	vector<StatementResult> results;
+	bool initialized = false;
+	// created on the first call, and kept for the stats of the extraction
+	unique_ptr<CachedParser> parser;
+	// the statements of the script, generated one batch at a time
+	StatementCursor<StatementResult> cursor;
 };
 
 struct ParseStatementsBindData : public TableFunctionData {
 	string sql;
+	ParserOptions options;
+	// return the statements re-generated from the AST instead of slices of the input
+	bool normalized = true;
 };
 
 // BIND function: runs during query planning to decide output schema
@@ -30,6 +42,11 @@ static unique_ptr<FunctionData> ParseStatementsBind(ClientContext &context,
 	// Create a bind data object to hold the SQL input
 	auto result = make_uniq<ParseStatementsBindData>();
 	result->sql = sql_input;
+	result->options = context.GetParserOptions();
+	auto normalized = input.named_parameters.find("normalized");
+	if (normalized != input.named_parameters.end() && !normalized->second.IsNull()) {
+		result->normalized = BooleanValue::Get(normalized->second);
+	}
 
 	return std::move(result);
 }
@@ -40,23 +57,37 @@ static unique_ptr<GlobalTableFunctionState> ParseStatementsInit(ClientContext &c
 	return make_uniq<ParseStatementsState>();
 }
 
-static void ExtractStatementsFromSQL(const std::string &sql, std::vector<StatementResult> &results) {
-	Parser parser;
+// Returns the original text of a statement: the slice of the input it was parsed from,
+// without surrounding whitespace and the terminating semicolon. Comments and formatting are kept.
+static string_t GetStatementText(const SQLStatement &stmt, const char *sql, idx_t size) {
+	idx_t start = MinValue<idx_t>(stmt.stmt_location, size);
+	idx_t end = stmt.stmt_length == 0 ? size : MinValue<idx_t>(start + stmt.stmt_length, size);
+	while (start < end && StringUtil::CharacterIsSpace(sql[start])) {
+		start++;
+	}
+	while (end > start && (StringUtil::CharacterIsSpace(sql[end - 1]) || sql[end - 1] == ';')) {
+		end--;
+	}
+	return string_t(sql + start, UnsafeNumericCast<uint32_t>(end - start));
+}
 
-	try {
-		parser.ParseQuery(sql);
-	} catch (const ParserException &ex) {
-		// Swallow parser exceptions to make this function more robust
-		return;
+// Appends the text of a statement of `sql`: re-generated from the AST when normalized, else its slice of the input
+static void ExtractStatement(const SQLStatement &stmt, const string &sql, bool normalized, std::vector<StatementResult> &results) {
+	if (normalized) {
+		results.push_back(StatementResult{stmt.ToString()});
+	} else {
+		results.push_back(StatementResult{GetStatementText(stmt, sql.c_str(), sql.size()).GetString()});
 	}
+}
 
-	for (auto &stmt : parser.statements) {
+static idx_t CountStatements(const vector<unique_ptr<SQLStatement>> &statements) {
+	idx_t count = 0;
+	for (auto &stmt : statements) {
 		if (stmt) {
-			// Convert statement back to string
-			auto statement_str = stmt->ToString();
-			results.push_back(StatementResult{statement_str});
+			count++;
 		}
 	}
+	return count;
 }
 
 static void ParseStatementsFunction(ClientContext &context,
@@ -65,61 +96,152 @@ static void ParseStatementsFunction(ClientContext &context,
 	auto &state = (ParseStatementsState &)*data.global_state;
 	auto &bind_data = (ParseStatementsBindData &)*data.bind_data;
 
-	if (state.results.empty() && state.row == 0) {
-		ExtractStatementsFromSQL(bind_data.sql, state.results);
+	if (!state.initialized) {
+		state.parser = make_uniq<CachedParser>(context, bind_data.options, "parse_statements");
+		state.cursor.Reset(state.parser->Parse(bind_data.sql), state.parser->Counters());
+		state.initialized = true;
 	}
-
-	if (state.row >= state.results.size()) {
+	auto &cursor = state.cursor;
+	if (!cursor.Next([&](const SQLStatement &stmt, vector<StatementResult> &results) {
+		ExtractStatement(stmt, bind_data.sql, bind_data.normalized, results);
+	})) {
+		output.SetCardinality(0);
 		return;
 	}
 
-	auto &stmt = state.results[state.row];
-	output.SetCardinality(1);
-	output.SetValue(0, 0, Value(stmt.statement));
+	// fill the chunk up to STANDARD_VECTOR_SIZE, writing directly into the flat string vector
+	auto statement_data = FlatVector::GetData<string_t>(output.data[0]);
 
-	state.row++;
+	auto count = cursor.ChunkSize();
+	{
+		StatsTimer timer(state.parser->Counters().materialize_ns);
+		for (idx_t i = 0; i < count; i++) {
+			statement_data[i] = StringVector::AddString(output.data[0], cursor.results[cursor.row + i].statement);
+		}
+	}
+	cursor.row += count;
+	output.SetCardinality(count);
 }
 
-static void ParseStatementsScalarFunction(DataChunk &args, ExpressionState &state, Vector &result) {
-	UnaryExecutor::Execute<string_t, list_entry_t>(args.data[0], result, args.size(),
-	[&result](string_t query) -> list_entry_t {
-		// Parse the SQL query and extract statements
-		auto query_string = query.GetString();
-		std::vector<StatementResult> parsed_statements;
-		ExtractStatementsFromSQL(query_string, parsed_statements);
-
-		auto current_size = ListVector::GetListSize(result);
-		auto number_of_statements = parsed_statements.size();
-		auto new_size = current_size + number_of_statements;
-
-		// Grow list if needed
-		if (ListVector::GetListCapacity(result) < new_size) {
-			ListVector::Reserve(result, new_size);
-		}
+// File scan variant: parse_statements_scan('migrations/*.sql') parses every matching file on the worker threads and
+// streams (filename, statement) rows
+struct ParseStatementsScanBindData : public ParseScanBindData {
+	ParseStatementsScanBindData(string function_name_p, vector<string> files_p, ParserOptions options_p, bool normalized_p)
+	    : ParseScanBindData(std::move(function_name_p), std::move(files_p), std::move(options_p), ParseTarget::Any),
+	      normalized(normalized_p) {
+	}
 
-		// Write the statements into the child vector
-		auto statements = FlatVector::GetData<string_t>(ListVector::GetEntry(result));
-		for (size_t i = 0; i < parsed_statements.size(); i++) {
-			auto &stmt = parsed_statements[i];
-			statements[current_size + i] = StringVector::AddStringOrBlob(ListVector::GetEntry(result), stmt.statement);
-		}
+	bool normalized;
+};
+
+static unique_ptr<FunctionData> ParseStatementsScanBind(ClientContext &context,
+														TableFunctionBindInput &input,
+														vector<LogicalType> &return_types,
+														vector<string> &names) {
+	return_types = {LogicalType::VARCHAR, LogicalType::VARCHAR};
+	names = {"filename", "statement"};
+	bool normalized = true;
+	auto entry = input.named_parameters.find("normalized");
+	if (entry != input.named_parameters.end() && !entry->second.IsNull()) {
+		normalized = BooleanValue::Get(entry->second);
+	}
+	auto files = GlobQueryFiles(context, StringValue::Get(input.inputs[0]));
+	return make_uniq<ParseStatementsScanBindData>(input.table_function.name, std::move(files), context.GetParserOptions(), normalized);
+}
+
+static bool WriteStatementColumn(column_t column_id, Vector &vector, const vector<StatementResult> &results, idx_t offset, idx_t count) {
+	if (column_id != 0) {
+		return false;
+	}
+	auto data = FlatVector::GetData<string_t>(vector);
+	for (idx_t i = 0; i < count; i++) {
+		data[i] = StringVector::AddString(vector, results[offset + i].statement);
+	}
+	return true;
+}
 
-		// Update size
-		ListVector::SetListSize(result, new_size);
+static void ParseStatementsScanFunction(ClientContext &context,
+										TableFunctionInput &data,
+										DataChunk &output) {
+	auto &bind_data = (const ParseStatementsScanBindData &)*data.bind_data;
+	ParseScanExecute<StatementResult>(context, data, output,
+	[&](const SQLStatement &stmt, const string &contents, vector<StatementResult> &results) {
+		ExtractStatement(stmt, contents, bind_data.normalized, results);
+	}, WriteStatementColumn);
+}
 
-		return list_entry_t(current_size, number_of_statements);
+static void ParseStatementsScalarFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &parser = ParserToolsLocalState::Get(state).parser;
+	auto serialized = IsSerializedArgument(args.data[0]);
+	auto &child = ListVector::GetEntry(result);
+	// the statements of the whole chunk are collected first and written to the list child once at the end.
+	// Re-generated statements are added to the child's string heap directly. Slices of SQL text point into the
+	// input, whose string heap the child keeps alive; only slices of the text stored in a blob are copied.
+	// The flag of each statement tells whether it is valid in the child as is
+	if (!serialized) {
+		StringVector::AddHeapReference(child, args.data[0]);
+	}
+	ListResultBuilder<std::pair<string_t, bool>> builder(result, parser.Counters());
+	auto extract_statements = [&builder, &child, &parser, serialized](string_t query, bool normalized,
+	                                                                   bool &is_null) -> list_entry_t {
+		auto parsed = parser.ParseArgument(query, serialized);
+		// the text the statements were parsed from: the input, or the text stored in the blob
+		auto sql = serialized ? string_t(parsed->sql.c_str(), UnsafeNumericCast<uint32_t>(parsed->sql.size())) : query;
+		return builder.Append(parsed, is_null, [&](vector<std::pair<string_t, bool>> &statements) {
+			for (auto &stmt : parsed->statements) {
+				if (!stmt) {
+					continue;
+				}
+				if (normalized) {
+					statements.emplace_back(StringVector::AddStringOrBlob(child, stmt->ToString()), true);
+				} else {
+					statements.emplace_back(GetStatementText(*stmt, sql.GetData(), sql.GetSize()), !serialized);
+				}
+			}
+		});
+	};
+
+	// parse_statements(sql_query [, normalized]): normalized defaults to true
+	if (args.ColumnCount() == 1 || (args.data[1].GetVectorType() == VectorType::CONSTANT_VECTOR && !ConstantVector::IsNull(args.data[1]))) {
+		bool normalized = args.ColumnCount() == 1 || ConstantVector::GetData<bool>(args.data[1])[0];
+		DeduplicatingExecutor::ExecuteWithNulls<list_entry_t>(args.data[0], result, args.size(),
+		[&](string_t query, bool &is_null) -> list_entry_t {
+			return extract_statements(query, normalized, is_null);
+		});
+	} else {
+		BinaryExecutor::ExecuteWithNulls<string_t, bool, list_entry_t>(args.data[0], args.data[1], result, args.size(),
+		[&](string_t query, bool normalized, ValidityMask &mask, idx_t idx) -> list_entry_t {
+			bool is_null = false;
+			auto entry = extract_statements(query, normalized, is_null);
+			if (is_null) {
+				mask.SetInvalid(idx);
+			}
+			return entry;
+		});
+	}
+
+	builder.Finalize([](Vector &child, idx_t offset, const vector<std::pair<string_t, bool>> &statements) {
+		auto statement_data = FlatVector::GetData<string_t>(child);
+		for (idx_t i = 0; i < statements.size(); i++) {
+			auto &statement = statements[i];
+			// slices of a blob's text: a single copy
+			statement_data[offset + i] = statement.second ? statement.first : StringVector::AddStringOrBlob(child, statement.first);
+		}
 	});
 }
 
 static void NumStatementsScalarFunction(DataChunk &args, ExpressionState &state, Vector &result) {
-	UnaryExecutor::Execute<string_t, int64_t>(args.data[0], result, args.size(),
-	[](string_t query) -> int64_t {
-		// Parse the SQL query and count statements
-		auto query_string = query.GetString();
-		std::vector<StatementResult> parsed_statements;
-		ExtractStatementsFromSQL(query_string, parsed_statements);
-
-		return static_cast<int64_t>(parsed_statements.size());
+	auto &parser = ParserToolsLocalState::Get(state).parser;
+	auto serialized = IsSerializedArgument(args.data[0]);
+	DeduplicatingExecutor::ExecuteWithNulls<int64_t>(args.data[0], result, args.size(),
+	[&parser, serialized](string_t query, bool &is_null) -> int64_t {
+		// only the count is needed: don't regenerate the SQL text of the statements
+		auto parsed = parser.ParseArgument(query, serialized);
+		if (parsed->SkippedByLimit()) {
+			is_null = true;
+			return 0;
+		}
+		return static_cast<int64_t>(CountStatements(parsed->statements));
 	});
 }
 
@@ -129,17 +251,33 @@ static void NumStatementsScalarFunction(DataChunk &args, ExpressionState &state,
 void RegisterParseStatementsFunction(ExtensionLoader &loader) {
 	// Table function that returns one row per statement
 	TableFunction tf("parse_statements", {LogicalType::VARCHAR}, ParseStatementsFunction, ParseStatementsBind, ParseStatementsInit);
+	// normalized := false returns the original text of each statement instead of the re-generated SQL
+	tf.named_parameters["normalized"] = LogicalType::BOOLEAN;
 	loader.RegisterFunction(tf);
+
+	// parse_statements_scan(glob) reads and parses files in parallel, one file per thread at a time
+	TableFunction scan("parse_statements_scan", {LogicalType::VARCHAR}, ParseStatementsScanFunction, ParseStatementsScanBind, ParseScanInitGlobal, ParseScanInitLocal<StatementResult>);
+	scan.projection_pushdown = true;
+	scan.named_parameters["normalized"] = LogicalType::BOOLEAN;
+	loader.RegisterFunction(scan);
 }
 
 void RegisterParseStatementsScalarFunction(ExtensionLoader &loader) {
 	// parse_statements is a scalar function that returns a list of statement strings
-	ScalarFunction sf("parse_statements", {LogicalType::VARCHAR}, LogicalType::LIST(LogicalType::VARCHAR), ParseStatementsScalarFunction);
-	loader.RegisterFunction(sf);
+	// usage: parse_statements(sql_query [, normalized])
+	ScalarFunctionSet set("parse_statements");
+	set.AddFunction(ParserToolsScalarFunction("parse_statements", {LogicalType::VARCHAR}, LogicalType::LIST(LogicalType::VARCHAR), ParseStatementsScalarFunction));
+	set.AddFunction(ParserToolsScalarFunction("parse_statements", {LogicalType::VARCHAR, LogicalType::BOOLEAN}, LogicalType::LIST(LogicalType::VARCHAR), ParseStatementsScalarFunction));
+	// the same over queries persisted with parse_to_blob
+	set.AddFunction(ParserToolsScalarFunction("parse_statements", {LogicalType::BLOB}, LogicalType::LIST(LogicalType::VARCHAR), ParseStatementsScalarFunction));
+	set.AddFunction(ParserToolsScalarFunction("parse_statements", {LogicalType::BLOB, LogicalType::BOOLEAN}, LogicalType::LIST(LogicalType::VARCHAR), ParseStatementsScalarFunction));
+	loader.RegisterFunction(set);
 
 	// num_statements is a scalar function that returns the count of statements
-	ScalarFunction num_sf("num_statements", {LogicalType::VARCHAR}, LogicalType::BIGINT, NumStatementsScalarFunction);
-	loader.RegisterFunction(num_sf);
+	ScalarFunctionSet num_set("num_statements");
+	num_set.AddFunction(ParserToolsScalarFunction("num_statements", {LogicalType::VARCHAR}, LogicalType::BIGINT, NumStatementsScalarFunction));
+	num_set.AddFunction(ParserToolsScalarFunction("num_statements", {LogicalType::BLOB}, LogicalType::BIGINT, NumStatementsScalarFunction));
+	loader.RegisterFunction(num_set);
 }
 
 } // namespace duckdb
\ No newline at end of file
@@ -1,4 +1,14 @@
 #include "parse_tables.hpp"
+#include "ast_collectors.hpp"
+#include "parse_in_out.hpp"
+#include "parse_scan.hpp"
+#include "statement_cursor.hpp"
+#include "parse_cache.hpp"
+#include "parser_tools_state.hpp"
+#include "deduplicating_executor.hpp"
+#include "list_result_builder.hpp"
+#include "projected_columns.hpp"
+#include "context_enum.hpp"
 #include "duckdb.hpp"
 #include "duckdb/parser/parser.hpp"
 #include "duckdb/parser/parser_options.hpp"
@@ -14,7 +24,7 @@
 
 namespace duckdb {
 
-inline const char *ToString(TableContext context) {
+const char *ToString(TableContext context) {
     switch (context) {
         case TableContext::From: return "from";
         case TableContext::JoinLeft: return "join_left";
@@ -26,7 +36,11 @@ inline const char *ToString(TableContext context) {
     }
 }
 
-inline const TableContext FromString(const char *context) {
+LogicalType TableContextType() {
+    return CreateContextEnumType<TableContext>(static_cast<idx_t>(TableContext::Subquery) + 1);
+}
+
+const TableContext FromString(const char *context) {
     if (strcmp(context, "from") == 0) return TableContext::From;
     if (strcmp(context, "join_left") == 0) return TableContext::JoinLeft;
     if (strcmp(context, "join_right") == 0) return TableContext::JoinRight;
@@ -37,14 +51,72 @@ inline const TableContext FromString(const char *context) {
 }
 
 struct ParseTablesState : public GlobalTableFunctionState {
-    idx_t row = 0;
-    vector<TableRefResult> results;
+    bool initialized = false;
+    // created on the first call, and kept for the stats of the extraction
+    unique_ptr<CachedParser> parser;
+    // the results of the script, extracted one batch of statements at a time
+    StatementCursor<TableRefResult> cursor;
+    ProjectedColumns projection;
 };
 
 struct ParseTablesBindData : public TableFunctionData {
     string sql;
+    ParserOptions options;
+    table_context_mask_t contexts = ALL_TABLE_CONTEXTS;
+};
+
+struct ParseTablesInOutBindData : public ParseInOutBindData {
+    ParseTablesInOutBindData(string function_name_p, ParserOptions options_p, table_context_mask_t contexts_p)
+        : ParseInOutBindData(std::move(function_name_p), std::move(options_p), ParseTarget::Tables), contexts(contexts_p) {
+    }
+
+    table_context_mask_t contexts;
+};
+
+struct ParseTablesScanBindData : public ParseScanBindData {
+    ParseTablesScanBindData(string function_name_p, vector<string> files_p, ParserOptions options_p, table_context_mask_t contexts_p)
+        : ParseScanBindData(std::move(function_name_p), std::move(files_p), std::move(options_p), ParseTarget::Tables), contexts(contexts_p) {
+    }
+
+    table_context_mask_t contexts;
 };
 
+static table_context_mask_t GetTableContextListMask(const Value &list, const string &parameter) {
+    table_context_mask_t mask = 0;
+    for (auto &entry : ListValue::GetChildren(list)) {
+        if (entry.IsNull()) {
+            continue;
+        }
+        auto name = StringValue::Get(entry);
+        bool found = false;
+        for (uint32_t i = 0; i <= static_cast<uint32_t>(TableContext::Subquery); i++) {
+            auto context = static_cast<TableContext>(i);
+            if (StringUtil::CIEquals(name, ToString(context))) {
+                mask |= TableContextBit(context);
+                found = true;
+                break;
+            }
+        }
+        if (!found) {
+            throw BinderException("Unknown table context \"%s\" for %s, expected one of from, join_left, join_right, from_cte, cte, subquery", name, parameter);
+        }
+    }
+    return mask;
+}
+
+table_context_mask_t GetTableContextMask(const named_parameter_map_t &named_parameters) {
+    table_context_mask_t mask = ALL_TABLE_CONTEXTS;
+    auto contexts = named_parameters.find("contexts");
+    if (contexts != named_parameters.end() && !contexts->second.IsNull()) {
+        mask = GetTableContextListMask(contexts->second, "contexts");
+    }
+    auto exclude_contexts = named_parameters.find("exclude_contexts");
+    if (exclude_contexts != named_parameters.end() && !exclude_contexts->second.IsNull()) {
+        mask &= ~GetTableContextListMask(exclude_contexts->second, "exclude_contexts");
+    }
+    return mask;
+}
+
 // BIND function: runs during query planning to decide output schema
 static unique_ptr<FunctionData> ParseTablesBind(ClientContext &context, 
                                     TableFunctionBindInput &input, 
@@ -55,7 +127,7 @@ static unique_ptr<FunctionData> ParseTablesBind(ClientContext &context,
                                                     
     // always return the same columns:
 
-    return_types = {LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::VARCHAR};
+    return_types = {LogicalType::VARCHAR, LogicalType::VARCHAR, TableContextType()};
     // schema name, table name, usage context (from, join, cte, etc)
     names = {"schema", "table", "context"};
     
@@ -63,6 +135,8 @@ static unique_ptr<FunctionData> ParseTablesBind(ClientContext &context,
     
     auto result = make_uniq<ParseTablesBindData>();
     result->sql = sql_input;
+    result->options = context.GetParserOptions();
+    result->contexts = GetTableContextMask(input.named_parameters);
 
     return std::move(result);
 }
@@ -70,124 +144,45 @@ static unique_ptr<FunctionData> ParseTablesBind(ClientContext &context,
 // INIT function: runs before table function execution
 static unique_ptr<GlobalTableFunctionState> ParseTablesInit(ClientContext &context,
     TableFunctionInitInput &input) {
-    return make_uniq<ParseTablesState>();
+    auto state = make_uniq<ParseTablesState>();
+    state->projection = ProjectedColumns(input.column_ids);
+    return std::move(state);
 }
 
-static void ExtractTablesFromRef(
-    const duckdb::TableRef &ref,
-    std::vector<TableRefResult> &results,
-    const TableContext context = TableContext::From,
-    bool is_top_level = false,
-    const duckdb::CommonTableExpressionMap *cte_map = nullptr
-) {
-    using namespace duckdb;
-
-    switch (ref.type) {
-        case TableReferenceType::BASE_TABLE: {
-            auto &base = (BaseTableRef &)ref;
-            TableContext context_label = context;
-
-            if (cte_map && cte_map->map.find(base.table_name) != cte_map->map.end()) {
-                context_label = TableContext::FromCTE;
-            } else if (is_top_level) {
-                context_label = TableContext::From;
-            }
-
-            results.push_back(TableRefResult{
-                base.schema_name.empty() ? "main" : base.schema_name,
-                base.table_name,
-                context_label
-            });
-            break;
-        }
-        case TableReferenceType::JOIN: {
-            auto &join = (JoinRef &)ref;
-            ExtractTablesFromRef(*join.left, results, TableContext::JoinLeft, is_top_level, cte_map);
-            ExtractTablesFromRef(*join.right, results, TableContext::JoinRight, false, cte_map);
-            break;
-        }
-        case TableReferenceType::SUBQUERY: {
-            auto &subquery = (SubqueryRef &)ref;
-            if (subquery.subquery && subquery.subquery->node) {
-                ExtractTablesFromQueryNode(*subquery.subquery->node, results, TableContext::Subquery, cte_map);
-            }
-            break;
-        }
-        default:
-            break;
-    }
+void ExtractTablesFromStatements(const vector<unique_ptr<SQLStatement>> &statements, std::vector<TableRefResult> &results,
+                                 table_context_mask_t contexts) {
+    TableCollector collector(results, contexts);
+    WalkStatements(statements, collector);
 }
 
-
-static void ExtractTablesFromQueryNode(
-    const duckdb::QueryNode &node,
-    std::vector<TableRefResult> &results,
-    const TableContext context,
-    const duckdb::CommonTableExpressionMap *cte_map
-) {
-    using namespace duckdb;
-
-    if (node.type == QueryNodeType::SELECT_NODE) {
-        auto &select_node = (SelectNode &)node;
-
-        // Handle CTE definitions
-        for (const auto &entry : select_node.cte_map.map) {
-            results.push_back(TableRefResult{
-                "", entry.first, TableContext::CTE
-            });
-
-            if (entry.second && entry.second->query && entry.second->query->node) {
-                ExtractTablesFromQueryNode(*entry.second->query->node, results, TableContext::From, &select_node.cte_map);
-            }
-        }
-
-        if (select_node.from_table) {
-            ExtractTablesFromRef(*select_node.from_table, results, context, true, &select_node.cte_map);
-        }
-    } 
-    // additional step necessary for duckdb v1.4.0: unwrap CTE node
-    else if (node.type == QueryNodeType::CTE_NODE) {
-        auto &cte_node = (CTENode &)node;
-
-        if (cte_node.child) {
-            ExtractTablesFromQueryNode(*cte_node.child, results, context, cte_map);
-        }
-    }
+void ExtractTablesFromStatement(const SQLStatement &statement, std::vector<TableRefResult> &results,
+                                table_context_mask_t contexts) {
+    TableCollector collector(results, contexts);
+    WalkStatement(statement, collector);
 }
 
-static void ExtractTablesFromSQL(const std::string &sql, std::vector<TableRefResult> &results) {
-    Parser parser;
-
-    try {
-        parser.ParseQuery(sql);
-    } catch (const ParserException &ex) {
-        // swallow parser exceptions to make this function more robust. is_parsable can be used if needed
-        return;
-    }
-
-    for (auto &stmt : parser.statements) {
-        if (stmt->type == StatementType::SELECT_STATEMENT) {
-            auto &select_stmt = (SelectStatement &)*stmt;
-            if (select_stmt.node) {
-                ExtractTablesFromQueryNode(*select_stmt.node, results);
+// Writes column `column_id` (schema, table, context) of `count` results starting at `offset`.
+// Returns false for unknown column ids
+static bool WriteTableColumn(column_t column_id, Vector &vector, const vector<TableRefResult> &results, idx_t offset, idx_t count) {
+    auto data = FlatVector::GetData<string_t>(vector);
+    switch (column_id) {
+        case 0:
+            for (idx_t i = 0; i < count; i++) {
+                data[i] = StringVector::AddString(vector, results[offset + i].schema);
             }
-        }
-    }
-}
-
-static void ExtractTablesFromSQL(const std::string & sql, std::vector<TableRefResult> &result, std::unordered_set<std::string> excluded_types) {
-    std::vector<TableRefResult> temp_result;
-    ExtractTablesFromSQL(sql, temp_result);
-    std::unordered_set<TableContext> e_types;
-
-    for (auto &type : excluded_types) {
-        e_types.insert(FromString(type.c_str()));
-    }
-
-    for (auto &table : temp_result) {
-        if (e_types.count(table.context) == 0) {
-            result.push_back(table);
-        }
+            return true;
+        case 1:
+            for (idx_t i = 0; i < count; i++) {
+                data[i] = StringVector::AddString(vector, results[offset + i].table);
+            }
+            return true;
+        case 2:
+            for (idx_t i = 0; i < count; i++) {
+                SetContext(vector, i, results[offset + i].context);
+            }
+            return true;
+        default:
+            return false;
     }
 }
 
@@ -197,21 +192,75 @@ static void ParseTablesFunction(ClientContext &context,
     auto &state = (ParseTablesState &)*data.global_state;
     auto &bind_data = (ParseTablesBindData &)*data.bind_data;
 
-    if (state.results.empty() && state.row == 0) {
-        ExtractTablesFromSQL(bind_data.sql, state.results);
+    if (!state.initialized) {
+        state.parser = make_uniq<CachedParser>(context, bind_data.options, "parse_tables");
+        state.cursor.Reset(state.parser->Parse(bind_data.sql, ParseTarget::Tables), state.parser->Counters());
+        state.initialized = true;
     }
-
-    if (state.row >= state.results.size()) {
+    auto &cursor = state.cursor;
+    if (!cursor.Next([&](const SQLStatement &statement, vector<TableRefResult> &results) {
+            ExtractTablesFromStatement(statement, results, bind_data.contexts);
+        })) {
+        output.SetCardinality(0);
         return;
     }
 
-    auto &ref = state.results[state.row];
-    output.SetCardinality(1);
-    output.SetValue(0, 0, Value(ref.schema));
-    output.SetValue(1, 0, Value(ref.table));
-    output.SetValue(2, 0, Value(ToString(ref.context)));
+    // fill the chunk up to STANDARD_VECTOR_SIZE, writing only the projected columns
+    auto count = cursor.ChunkSize();
+    state.projection.Write(output, cursor.row, count, state.parser->Counters(), [&](column_t column_id, Vector &vector, idx_t offset, idx_t count) -> bool {
+        return WriteTableColumn(column_id, vector, cursor.results, offset, count);
+    });
+    cursor.row += count;
+}
+
+// In-out variant: parse_tables_lateral(sql) consumes a column of queries and streams
+// (row_id, schema, table, context) rows, e.g. FROM query_history q, parse_tables_lateral(q.sql)
+static unique_ptr<FunctionData> ParseTablesInOutBind(ClientContext &context,
+                                    TableFunctionBindInput &input,
+                                    vector<LogicalType> &return_types,
+                                    vector<string> &names) {
+    return_types = {LogicalType::BIGINT, LogicalType::VARCHAR, LogicalType::VARCHAR, TableContextType()};
+    names = {"row_id", "schema", "table", "context"};
+    return make_uniq<ParseTablesInOutBindData>(input.table_function.name, context.GetParserOptions(), GetTableContextMask(input.named_parameters));
+}
+
+static OperatorResultType ParseTablesInOutFunction(ExecutionContext &context,
+                   TableFunctionInput &data,
+                   DataChunk &input,
+                   DataChunk &output) {
+    auto &bind_data = (const ParseTablesInOutBindData &)*data.bind_data;
+    auto contexts = bind_data.contexts;
+    return ParseInOutExecute<TableRefResult>(context, data, input, output,
+    [contexts](const ParsedQuery &parsed, std::vector<TableRefResult> &results) {
+        ExtractTablesFromStatements(parsed.statements, results, contexts);
+    },
+    [](DataChunk &output, idx_t idx, const TableRefResult &ref) {
+        FlatVector::GetData<string_t>(output.data[1])[idx] = StringVector::AddString(output.data[1], ref.schema);
+        FlatVector::GetData<string_t>(output.data[2])[idx] = StringVector::AddString(output.data[2], ref.table);
+        SetContext(output.data[3], idx, ref.context);
+    });
+}
+
+// File scan variant: parse_tables_scan('queries/**/*.sql') parses every matching file on the worker threads and
+// streams (filename, schema, table, context) rows
+static unique_ptr<FunctionData> ParseTablesScanBind(ClientContext &context,
+                                    TableFunctionBindInput &input,
+                                    vector<LogicalType> &return_types,
+                                    vector<string> &names) {
+    return_types = {LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::VARCHAR, TableContextType()};
+    names = {"filename", "schema", "table", "context"};
+    auto files = GlobQueryFiles(context, StringValue::Get(input.inputs[0]));
+    return make_uniq<ParseTablesScanBindData>(input.table_function.name, std::move(files), context.GetParserOptions(), GetTableContextMask(input.named_parameters));
+}
 
-    state.row++;
+static void ParseTablesScanFunction(ClientContext &context,
+                   TableFunctionInput &data,
+                   DataChunk &output) {
+    auto &bind_data = (const ParseTablesScanBindData &)*data.bind_data;
+    ParseScanExecute<TableRefResult>(context, data, output,
+    [&](const SQLStatement &statement, const string &contents, vector<TableRefResult> &results) {
+        ExtractTablesFromStatement(statement, results, bind_data.contexts);
+    }, WriteTableColumn);
 }
 
 static void ParseTablesScalarFunction(DataChunk &args, ExpressionState &state, Vector &result) {
@@ -229,112 +278,167 @@ static void ParseTablesScalarFunction(DataChunk &args, ExpressionState &state, V
         throw InvalidInputException("parse_tables() expects 1 or 2 arguments");
     }
 
-    // Execute does the heavy lifting of iterating over the input data
-    // and calling the provided lambda function for each input value.
     // The lambda function is responsible for parsing the SQL query and
-    // extracting the table names.
-    BinaryExecutor::Execute<string_t, bool, list_entry_t>(args.data[0], flag, result, args.size(), 
-    [&result](string_t query, bool exclude_cte) -> list_entry_t {
+    // extracting the table names of a single input value.
+    // The names are collected for the whole chunk and written to the list child once at the end
+    auto &parser = ParserToolsLocalState::Get(state).parser;
+    auto serialized = IsSerializedArgument(args.data[0]);
+    ListResultBuilder<TableRefResult> builder(result, parser.Counters());
+    auto extract_table_names = [&builder, &parser, serialized](string_t query, bool exclude_cte,
+                                                               bool &is_null) -> list_entry_t {
         // Parse the SQL query and extract table names
-        auto query_string = query.GetString();
-        std::vector<TableRefResult> parsed_tables;
-        if (exclude_cte) {
-            std::unordered_set<std::string> excluded_types = {"cte", "from_cte"};
-            ExtractTablesFromSQL(query_string, parsed_tables, excluded_types);
-        } else {
-            ExtractTablesFromSQL(query_string, parsed_tables);
-        }
-        
-    
-        auto current_size = ListVector::GetListSize(result);
-        auto number_of_tables = parsed_tables.size();
-        auto new_size = current_size + number_of_tables;
-
-        // grow list if needed
-        if (ListVector::GetListCapacity(result) < new_size) {
-            ListVector::Reserve(result, new_size);
-        }
+        auto parsed = parser.ParseArgument(query, serialized, ParseTarget::Tables);
+        return builder.Append(parsed, is_null, [&](std::vector<TableRefResult> &tables) {
+            if (exclude_cte) {
+                ExtractTablesFromStatements(parsed->statements, tables, NON_CTE_CONTEXTS);
+            } else {
+                ExtractTablesFromStatements(parsed->statements, tables);
+            }
+        });
+    };
+
+    if (flag.GetVectorType() == VectorType::CONSTANT_VECTOR && !ConstantVector::IsNull(flag)) {
+        // the common case: parse each distinct query of the chunk only once
+        auto exclude_cte = ConstantVector::GetData<bool>(flag)[0];
+        DeduplicatingExecutor::ExecuteWithNulls<list_entry_t>(args.data[0], result, args.size(),
+        [&](string_t query, bool &is_null) -> list_entry_t {
+            return extract_table_names(query, exclude_cte, is_null);
+        });
+    } else {
+        BinaryExecutor::ExecuteWithNulls<string_t, bool, list_entry_t>(args.data[0], flag, result, args.size(),
+        [&](string_t query, bool exclude_cte, ValidityMask &mask, idx_t idx) -> list_entry_t {
+            bool is_null = false;
+            auto entry = extract_table_names(query, exclude_cte, is_null);
+            if (is_null) {
+                mask.SetInvalid(idx);
+            }
+            return entry;
+        });
+    }
 
-        // Write the string into the child vector
-        auto tables = FlatVector::GetData<string_t>(ListVector::GetEntry(result));
-        for (size_t i = 0; i < parsed_tables.size(); i++) {
-            auto &table = parsed_tables[i];
-            tables[current_size + i] = StringVector::AddStringOrBlob(ListVector::GetEntry(result), table.table);
+    builder.Finalize([](Vector &child, idx_t offset, const std::vector<TableRefResult> &tables) {
+        auto table_data = FlatVector::GetData<string_t>(child);
+        for (idx_t i = 0; i < tables.size(); i++) {
+            table_data[offset + i] = StringVector::AddStringOrBlob(child, tables[i].table);
         }
-
-        // Update size
-        ListVector::SetListSize(result, new_size);
-
-        return list_entry_t(current_size, number_of_tables); 
     });
 }
 
 static void ParseTablesScalarFunction_struct(DataChunk &args, ExpressionState &state, Vector &result) {
-    UnaryExecutor::Execute<string_t, list_entry_t>(args.data[0], result, args.size(),
-    [&result](string_t query) -> list_entry_t {
+    auto &parser = ParserToolsLocalState::Get(state).parser;
+    auto serialized = IsSerializedArgument(args.data[0]);
+    ListResultBuilder<TableRefResult> builder(result, parser.Counters());
+    DeduplicatingExecutor::ExecuteWithNulls<list_entry_t>(args.data[0], result, args.size(),
+    [&builder, &parser, serialized](string_t query, bool &is_null) -> list_entry_t {
         // Parse the SQL query and extract table names
-        auto query_string = query.GetString();
-        std::vector<TableRefResult> parsed_tables;
-        ExtractTablesFromSQL(query_string, parsed_tables);    
-
-        auto current_size = ListVector::GetListSize(result);
-        auto number_of_tables = parsed_tables.size();
-        auto new_size = current_size + number_of_tables;
-
-        // Grow list vector if needed
-        if (ListVector::GetListCapacity(result) < new_size) {
-            ListVector::Reserve(result, new_size);
-        }
-
-        // Get the struct child vector of the list
-        auto &struct_vector = ListVector::GetEntry(result);
-
-        // Ensure list size is updated
-        ListVector::SetListSize(result, new_size);
+        auto parsed = parser.ParseArgument(query, serialized, ParseTarget::Tables);
+        return builder.Append(parsed, is_null, [&](std::vector<TableRefResult> &tables) {
+            ExtractTablesFromStatements(parsed->statements, tables);
+        });
+    });
 
-        // Get the fields in the STRUCT
+    builder.Finalize([](Vector &struct_vector, idx_t offset, const std::vector<TableRefResult> &tables) {
+        // Get the fields in the STRUCT and fill them one at a time
         auto &entries = StructVector::GetEntries(struct_vector);
         auto &schema_entry = *entries[0]; // "schema" field
         auto &table_entry = *entries[1];  // "table" field
         auto &context_entry = *entries[2]; // "context" field
 
         auto schema_data = FlatVector::GetData<string_t>(schema_entry);
+        for (idx_t i = 0; i < tables.size(); i++) {
+            schema_data[offset + i] = StringVector::AddStringOrBlob(schema_entry, tables[i].schema);
+        }
         auto table_data = FlatVector::GetData<string_t>(table_entry);
-        auto context_data = FlatVector::GetData<string_t>(context_entry);
-
-
-        for (size_t i = 0; i < number_of_tables; i++) {
-            const auto &table = parsed_tables[i];
-            auto idx = current_size + i;
-
-            schema_data[idx] = StringVector::AddStringOrBlob(schema_entry, table.schema);
-            table_data[idx] = StringVector::AddStringOrBlob(table_entry, table.table);
-            context_data[idx] = StringVector::AddStringOrBlob(context_entry, ToString(table.context));
+        for (idx_t i = 0; i < tables.size(); i++) {
+            table_data[offset + i] = StringVector::AddStringOrBlob(table_entry, tables[i].table);
+        }
+        for (idx_t i = 0; i < tables.size(); i++) {
+            SetContext(context_entry, offset + i, tables[i].context);
         }
-
-        return list_entry_t(current_size, number_of_tables);
     });
 }
 
 static void IsParsableFunction(DataChunk &args, ExpressionState &state, Vector &result) {
-    UnaryExecutor::Execute<string_t, bool>(args.data[0], result, args.size(),
-    [](string_t query) -> bool {
-        try {
-            Parser parser;
-            parser.ParseQuery(query.GetString());
-            return true;
-        } catch (const std::exception &) {
+    auto &parser = ParserToolsLocalState::Get(state).parser;
+    DeduplicatingExecutor::ExecuteWithNulls<bool>(args.data[0], result, args.size(),
+    [&parser](string_t query, bool &is_null) -> bool {
+        auto parsed = parser.Parse(query);
+        switch (parsed->limit) {
+        case ParseLimit::QueryBytes:
+            // not parsed: unknown
+            is_null = true;
             return false;
+        case ParseLimit::Nodes:
+            // parsed, only too large to extract from
+            return true;
+        default:
+            return parsed->success;
         }
     });
 }
 
+static void ParseErrorFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+    auto &parser = ParserToolsLocalState::Get(state).parser;
+    auto count = args.size();
+
+    UnifiedVectorFormat sql_format;
+    args.data[0].ToUnifiedFormat(count, sql_format);
+    auto sql_data = UnifiedVectorFormat::GetData<string_t>(sql_format);
+
+    auto &entries = StructVector::GetEntries(result);
+    auto &message_vector = *entries[0];
+    auto &position_vector = *entries[1];
+    auto message_data = FlatVector::GetData<string_t>(message_vector);
+    auto position_data = FlatVector::GetData<int64_t>(position_vector);
+
+    for (idx_t i = 0; i < count; i++) {
+        auto idx = sql_format.sel->get_index(i);
+        // parsable queries (and NULL inputs) have no error
+        if (!sql_format.validity.RowIsValid(idx)) {
+            FlatVector::SetNull(result, i, true);
+            continue;
+        }
+        auto parsed = parser.Parse(sql_data[idx]);
+        if (parsed->success) {
+            FlatVector::SetNull(result, i, true);
+            continue;
+        }
+        message_data[i] = StringVector::AddString(message_vector, parsed->error);
+        if (parsed->error_location.IsValid()) {
+            position_data[i] = NumericCast<int64_t>(parsed->error_location.GetIndex());
+        } else {
+            FlatVector::SetNull(position_vector, i, true);
+        }
+    }
+    if (args.AllConstant()) {
+        result.SetVectorType(VectorType::CONSTANT_VECTOR);
+    }
+}
+
 // Extension scaffolding
 // ---------------------------------------------------
 
 void RegisterParseTablesFunction(ExtensionLoader &loader) {
     TableFunction tf("parse_tables", {LogicalType::VARCHAR}, ParseTablesFunction, ParseTablesBind, ParseTablesInit);
+    tf.projection_pushdown = true;
+    // contexts := [...] / exclude_contexts := [...] restrict the reported table contexts
+    tf.named_parameters["contexts"] = LogicalType::LIST(LogicalType::VARCHAR);
+    tf.named_parameters["exclude_contexts"] = LogicalType::LIST(LogicalType::VARCHAR);
     loader.RegisterFunction(tf);
+
+    // parse_tables_lateral is an in-out function that streams the tables of a column of queries
+    TableFunction in_out("parse_tables_lateral", {LogicalType::VARCHAR}, nullptr, ParseTablesInOutBind, ParseInOutInitGlobal, ParseInOutInitLocal<TableRefResult>);
+    in_out.in_out_function = ParseTablesInOutFunction;
+    in_out.named_parameters["contexts"] = LogicalType::LIST(LogicalType::VARCHAR);
+    in_out.named_parameters["exclude_contexts"] = LogicalType::LIST(LogicalType::VARCHAR);
+    loader.RegisterFunction(in_out);
+
+    // parse_tables_scan(glob) reads and parses files in parallel, one file per thread at a time
+    TableFunction scan("parse_tables_scan", {LogicalType::VARCHAR}, ParseTablesScanFunction, ParseTablesScanBind, ParseScanInitGlobal, ParseScanInitLocal<TableRefResult>);
+    scan.projection_pushdown = true;
+    scan.named_parameters["contexts"] = LogicalType::LIST(LogicalType::VARCHAR);
+    scan.named_parameters["exclude_contexts"] = LogicalType::LIST(LogicalType::VARCHAR);
+    loader.RegisterFunction(scan);
 }
 
 void RegisterParseTableScalarFunction(ExtensionLoader &loader) {
@@ -342,22 +446,35 @@ void RegisterParseTableScalarFunction(ExtensionLoader &loader) {
     // that indicates whether to include CTEs in the result
     // usage: parse_tables(sql_query [, include_cte])
     ScalarFunctionSet set("parse_table_names");
-    set.AddFunction(ScalarFunction({LogicalType::VARCHAR}, LogicalType::LIST(LogicalType::VARCHAR), ParseTablesScalarFunction));
-    set.AddFunction(ScalarFunction({LogicalType::VARCHAR, LogicalType::BOOLEAN}, LogicalType::LIST(LogicalType::VARCHAR), ParseTablesScalarFunction));
+    set.AddFunction(ParserToolsScalarFunction("parse_table_names", {LogicalType::VARCHAR}, LogicalType::LIST(LogicalType::VARCHAR), ParseTablesScalarFunction));
+    set.AddFunction(ParserToolsScalarFunction("parse_table_names", {LogicalType::VARCHAR, LogicalType::BOOLEAN}, LogicalType::LIST(LogicalType::VARCHAR), ParseTablesScalarFunction));
+    // the same over queries persisted with parse_to_blob
+    set.AddFunction(ParserToolsScalarFunction("parse_table_names", {LogicalType::BLOB}, LogicalType::LIST(LogicalType::VARCHAR), ParseTablesScalarFunction));
+    set.AddFunction(ParserToolsScalarFunction("parse_table_names", {LogicalType::BLOB, LogicalType::BOOLEAN}, LogicalType::LIST(LogicalType::VARCHAR), ParseTablesScalarFunction));
     loader.RegisterFunction(set);
 
     // parse_tables_struct is a scalar function that returns a list of structs
     auto return_type = LogicalType::LIST(LogicalType::STRUCT({
         {"schema", LogicalType::VARCHAR},
         {"table", LogicalType::VARCHAR},
-        {"context", LogicalType::VARCHAR}
+        {"context", TableContextType()}
     }));
-    ScalarFunction sf("parse_tables", {LogicalType::VARCHAR}, return_type, ParseTablesScalarFunction_struct);
-    loader.RegisterFunction(sf);
+    ScalarFunctionSet tables_set("parse_tables");
+    tables_set.AddFunction(ParserToolsScalarFunction("parse_tables", {LogicalType::VARCHAR}, return_type, ParseTablesScalarFunction_struct));
+    tables_set.AddFunction(ParserToolsScalarFunction("parse_tables", {LogicalType::BLOB}, return_type, ParseTablesScalarFunction_struct));
+    loader.RegisterFunction(tables_set);
 
     // is_parsable is a scalar function that returns a boolean indicating whether the SQL query is parsable (no parse errors)
-    ScalarFunction is_parsable("is_parsable", {LogicalType::VARCHAR}, LogicalType::BOOLEAN, IsParsableFunction);
+    auto is_parsable = ParserToolsScalarFunction("is_parsable", {LogicalType::VARCHAR}, LogicalType::BOOLEAN, IsParsableFunction);
     loader.RegisterFunction(is_parsable);
+
+    // parse_error returns the parser error message and its byte offset, or NULL if the SQL query is parsable
+    auto error_type = LogicalType::STRUCT({
+        {"message", LogicalType::VARCHAR},
+        {"position", LogicalType::BIGINT}
+    });
+    auto parse_error = ParserToolsScalarFunction("parse_error", {LogicalType::VARCHAR}, error_type, ParseErrorFunction);
+    loader.RegisterFunction(parse_error);
 }
 
 } // namespace duckdb
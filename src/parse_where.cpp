@@ -1,4 +1,12 @@
 #include "parse_where.hpp"
+#include "ast_collectors.hpp"
+#include "parse_in_out.hpp"
+#include "parse_cache.hpp"
+#include "parser_tools_state.hpp"
+#include "deduplicating_executor.hpp"
+#include "list_result_builder.hpp"
+#include "projected_columns.hpp"
+#include "context_enum.hpp"
 #include "duckdb.hpp"
 #include "duckdb/parser/parser.hpp"
 #include "duckdb/parser/statement/select_statement.hpp"
@@ -19,16 +27,34 @@
 #include "duckdb/parser/expression/positional_reference_expression.hpp"
 #include "duckdb/parser/expression/parameter_expression.hpp"
 #include "duckdb/parser/tableref/basetableref.hpp"
+#include "duckdb/parser/tableref/joinref.hpp"
 
 namespace duckdb {
 
+const char *ToString(ConditionContext context) {
+    switch (context) {
+        case ConditionContext::Where: return "WHERE";
+        case ConditionContext::Having: return "HAVING";
+        default: return "unknown";
+    }
+}
+
+LogicalType ConditionContextType() {
+    return CreateContextEnumType<ConditionContext>(static_cast<idx_t>(ConditionContext::Having) + 1);
+}
+
 struct ParseWhereState : public GlobalTableFunctionState {
     idx_t row = 0;
+    unique_ptr<CachedParser> parser;
+    // owns the expressions the results point into
+    shared_ptr<const ParsedQuery> parsed;
     vector<WhereConditionResult> results;
+    ProjectedColumns projection;
 };
 
 struct ParseWhereBindData : public TableFunctionData {
     string sql;
+    ParserOptions options;
 };
 
 static unique_ptr<FunctionData> ParseWhereBind(ClientContext &context, 
@@ -40,137 +66,83 @@ static unique_ptr<FunctionData> ParseWhereBind(ClientContext &context,
     return_types = {
         LogicalType::VARCHAR,  // condition
         LogicalType::VARCHAR,  // table_name
-        LogicalType::VARCHAR   // context
+        ConditionContextType()  // context
     };
     
     names = {"condition", "table_name", "context"};
     
     auto result = make_uniq<ParseWhereBindData>();
     result->sql = sql_input;
+    result->options = context.GetParserOptions();
 
     return std::move(result);
 }
 
 static unique_ptr<GlobalTableFunctionState> ParseWhereInit(ClientContext &context,
     TableFunctionInitInput &input) {
-    return make_uniq<ParseWhereState>();
-}
-
-static string ExpressionToString(const ParsedExpression &expr) {
-    return expr.ToString();
+    auto state = make_uniq<ParseWhereState>();
+    state->projection = ProjectedColumns(input.column_ids);
+    return std::move(state);
 }
 
+// Flattens the conjunctions of `root` into its conditions. Nested conjunctions are expanded through an explicit
+// work-list rather than recursion: generated filters can chain thousands of terms
 static void ExtractWhereConditionsFromExpression(
-    const ParsedExpression &expr,
+    const ParsedExpression &root,
     vector<WhereConditionResult> &results,
-    const string &context = "WHERE",
+    ConditionContext context = ConditionContext::Where,
     const string &table_name = ""
 ) {
-    if (expr.type == ExpressionType::INVALID) return;
-
-    switch (expr.GetExpressionClass()) {
-        case ExpressionClass::CONJUNCTION: {
-            auto &conj = (ConjunctionExpression &)expr;
-            for (auto &child : conj.children) {
-                ExtractWhereConditionsFromExpression(*child, results, context, table_name);
+    vector<const ParsedExpression *> pending {&root};
+    while (!pending.empty()) {
+        auto &expr = *pending.back();
+        pending.pop_back();
+        if (expr.type == ExpressionType::INVALID) continue;
+
+        switch (expr.GetExpressionClass()) {
+            case ExpressionClass::CONJUNCTION: {
+                // the children are popped in their original order
+                auto &conj = (ConjunctionExpression &)expr;
+                for (idx_t i = conj.children.size(); i > 0; i--) {
+                    pending.push_back(conj.children[i - 1].get());
+                }
+                break;
             }
-            break;
-        }
-        case ExpressionClass::COMPARISON: {
-            auto &comp = (ComparisonExpression &)expr;
-            results.push_back(WhereConditionResult{
-                ExpressionToString(comp),
-                table_name,
-                context
-            });
-            break;
-        }
-        case ExpressionClass::OPERATOR: {
-            auto &op = (OperatorExpression &)expr;
-            results.push_back(WhereConditionResult{
-                ExpressionToString(op),
-                table_name,
-                context
-            });
-            break;
-        }
-        case ExpressionClass::FUNCTION: {
-            auto &func = (FunctionExpression &)expr;
-            results.push_back(WhereConditionResult{
-                ExpressionToString(func),
-                table_name,
-                context
-            });
-            break;
+            case ExpressionClass::COMPARISON:
+            case ExpressionClass::OPERATOR:
+            case ExpressionClass::FUNCTION:
+            case ExpressionClass::BETWEEN:
+            case ExpressionClass::CASE:
+                results.push_back(WhereConditionResult{
+                    &expr,
+                    table_name,
+                    context
+                });
+                break;
+            default:
+                break;
         }
-        case ExpressionClass::BETWEEN: {
-            auto &between = (BetweenExpression &)expr;
-            results.push_back(WhereConditionResult{
-                ExpressionToString(between),
-                table_name,
-                context
-            });
-            break;
-        }
-        case ExpressionClass::CASE: {
-            auto &case_expr = (CaseExpression &)expr;
-            results.push_back(WhereConditionResult{
-                ExpressionToString(case_expr),
-                table_name,
-                context
-            });
-            break;
-        }
-        default:
-            break;
     }
 }
 
-static void ExtractWhereConditionsFromQueryNode(
-    const QueryNode &node,
-    vector<WhereConditionResult> &results
-) {
-    if (node.type == QueryNodeType::SELECT_NODE) {
-        auto &select_node = (SelectNode &)node;
-        string table_name = "(empty)";  // Default table name
-
-        // Extract table name from FROM clause
-        if (select_node.from_table) {
-            if (select_node.from_table->type == TableReferenceType::BASE_TABLE) {
-                auto &base = (BaseTableRef &)*select_node.from_table;
-                table_name = base.table_name;
-            }
-        }
-
-        // Extract WHERE conditions
-        if (select_node.where_clause) {
-            ExtractWhereConditionsFromExpression(*select_node.where_clause, results, "WHERE", table_name);
-        }
-
-        // Extract HAVING conditions
-        if (select_node.having) {
-            ExtractWhereConditionsFromExpression(*select_node.having, results, "HAVING", table_name);
-        }
+// The table a condition of `node` applies to: the FROM table if it is a base table
+static string GetConditionTableName(const SelectNode &node) {
+    if (node.from_table && node.from_table->type == TableReferenceType::BASE_TABLE) {
+        auto &base = (BaseTableRef &)*node.from_table;
+        return base.table_name;
     }
+    return "(empty)";  // Default table name
 }
 
-static void ExtractWhereConditionsFromSQL(const string &sql, vector<WhereConditionResult> &results) {
-    Parser parser;
-
-    try {
-        parser.ParseQuery(sql);
-    } catch (const ParserException &ex) {
-        return;
-    }
+void ExtractWhereConditions(const ParsedExpression &expr, FunctionContext clause, const SelectNode &node,
+                            vector<WhereConditionResult> &results) {
+    ExtractWhereConditionsFromExpression(expr, results, clause == FunctionContext::Having ? ConditionContext::Having : ConditionContext::Where,
+                                         GetConditionTableName(node));
+}
 
-    for (auto &stmt : parser.statements) {
-        if (stmt->type == StatementType::SELECT_STATEMENT) {
-            auto &select_stmt = (SelectStatement &)*stmt;
-            if (select_stmt.node) {
-                ExtractWhereConditionsFromQueryNode(*select_stmt.node, results);
-            }
-        }
-    }
+void ExtractWhereConditionsFromStatements(const vector<unique_ptr<SQLStatement>> &statements, vector<WhereConditionResult> &results) {
+    WhereCollector collector(results);
+    WalkStatements(statements, collector);
 }
 
 static void ParseWhereFunction(ClientContext &context,
@@ -179,75 +151,123 @@ static void ParseWhereFunction(ClientContext &context,
     auto &state = (ParseWhereState &)*data.global_state;
     auto &bind_data = (ParseWhereBindData &)*data.bind_data;
 
-    if (state.results.empty() && state.row == 0) {
-        ExtractWhereConditionsFromSQL(bind_data.sql, state.results);
+    if (!state.parser) {
+        state.parser = make_uniq<CachedParser>(context, bind_data.options, "parse_where");
+        state.parsed = state.parser->Parse(bind_data.sql);
+        StatsTimer timer(state.parser->Counters().walk_ns);
+        ExtractWhereConditionsFromStatements(state.parsed->statements, state.results);
+        state.parser->Counters().rows += state.results.size();
     }
 
-    if (state.row >= state.results.size()) {
-        return;
-    }
+    // fill the chunk up to STANDARD_VECTOR_SIZE, writing only the projected columns.
+    // The conditions are only rendered to SQL if the condition column is requested
+    auto count = MinValue<idx_t>(STANDARD_VECTOR_SIZE, state.results.size() - state.row);
+    auto &results = state.results;
+    state.projection.Write(output, state.row, count, state.parser->Counters(), [&](column_t column_id, Vector &vector, idx_t offset, idx_t count) -> bool {
+        auto data = FlatVector::GetData<string_t>(vector);
+        switch (column_id) {
+            case 0:
+                for (idx_t i = 0; i < count; i++) {
+                    data[i] = StringVector::AddString(vector, results[offset + i].Condition());
+                }
+                return true;
+            case 1:
+                for (idx_t i = 0; i < count; i++) {
+                    data[i] = StringVector::AddString(vector, results[offset + i].table_name);
+                }
+                return true;
+            case 2:
+                for (idx_t i = 0; i < count; i++) {
+                    SetContext(vector, i, results[offset + i].context);
+                }
+                return true;
+            default:
+                return false;
+        }
+    });
+    state.row += count;
+}
 
-    auto &result = state.results[state.row];
-    output.SetCardinality(1);
-    output.SetValue(0, 0, Value(result.condition));
-    output.SetValue(1, 0, Value(result.table_name));
-    output.SetValue(2, 0, Value(result.context));
+// In-out variant: parse_where_lateral(sql) consumes a column of queries and streams
+// (row_id, condition, table_name, context) rows
+static unique_ptr<FunctionData> ParseWhereInOutBind(ClientContext &context,
+                                    TableFunctionBindInput &input,
+                                    vector<LogicalType> &return_types,
+                                    vector<string> &names) {
+    return_types = {LogicalType::BIGINT, LogicalType::VARCHAR, LogicalType::VARCHAR, ConditionContextType()};
+    names = {"row_id", "condition", "table_name", "context"};
+    return make_uniq<ParseInOutBindData>(input.table_function.name, context.GetParserOptions());
+}
 
-    state.row++;
+static OperatorResultType ParseWhereInOutFunction(ExecutionContext &context,
+                   TableFunctionInput &data,
+                   DataChunk &input,
+                   DataChunk &output) {
+    return ParseInOutExecute<WhereConditionResult>(context, data, input, output,
+    [](const ParsedQuery &parsed, vector<WhereConditionResult> &results) {
+        ExtractWhereConditionsFromStatements(parsed.statements, results);
+    },
+    [](DataChunk &output, idx_t idx, const WhereConditionResult &result) {
+        FlatVector::GetData<string_t>(output.data[1])[idx] = StringVector::AddString(output.data[1], result.Condition());
+        FlatVector::GetData<string_t>(output.data[2])[idx] = StringVector::AddString(output.data[2], result.table_name);
+        SetContext(output.data[3], idx, result.context);
+    });
 }
 
 static void ParseWhereScalarFunction(DataChunk &args, ExpressionState &state, Vector &result) {
-    UnaryExecutor::Execute<string_t, list_entry_t>(args.data[0], result, args.size(),
-    [&result](string_t query) -> list_entry_t {
-        auto query_string = query.GetString();
-        vector<WhereConditionResult> conditions;
-        ExtractWhereConditionsFromSQL(query_string, conditions);
-
-        auto current_size = ListVector::GetListSize(result);
-        auto number_of_conditions = conditions.size();
-        auto new_size = current_size + number_of_conditions;
-
-        if (ListVector::GetListCapacity(result) < new_size) {
-            ListVector::Reserve(result, new_size);
-        }
+    auto &parser = ParserToolsLocalState::Get(state).parser;
+    auto serialized = IsSerializedArgument(args.data[0]);
+    ListResultBuilder<WhereConditionResult> builder(result, parser.Counters());
+    DeduplicatingExecutor::ExecuteWithNulls<list_entry_t>(args.data[0], result, args.size(),
+    [&builder, &parser, serialized](string_t query, bool &is_null) -> list_entry_t {
+        auto parsed = parser.ParseArgument(query, serialized);
+        return builder.Append(parsed, is_null, [&](vector<WhereConditionResult> &conditions) {
+            ExtractWhereConditionsFromStatements(parsed->statements, conditions);
+        });
+    });
 
-        auto &struct_vector = ListVector::GetEntry(result);
+    builder.Finalize([](Vector &struct_vector, idx_t offset, const vector<WhereConditionResult> &conditions) {
         auto &entries = StructVector::GetEntries(struct_vector);
         auto &condition_entry = *entries[0];
         auto &table_entry = *entries[1];
         auto &context_entry = *entries[2];
 
         auto condition_data = FlatVector::GetData<string_t>(condition_entry);
+        for (idx_t i = 0; i < conditions.size(); i++) {
+            condition_data[offset + i] = StringVector::AddStringOrBlob(condition_entry, conditions[i].Condition());
+        }
         auto table_data = FlatVector::GetData<string_t>(table_entry);
-        auto context_data = FlatVector::GetData<string_t>(context_entry);
-
-        for (size_t i = 0; i < number_of_conditions; i++) {
-            const auto &condition = conditions[i];
-            auto idx = current_size + i;
-
-            condition_data[idx] = StringVector::AddStringOrBlob(condition_entry, condition.condition);
-            table_data[idx] = StringVector::AddStringOrBlob(table_entry, condition.table_name);
-            context_data[idx] = StringVector::AddStringOrBlob(context_entry, condition.context);
+        for (idx_t i = 0; i < conditions.size(); i++) {
+            table_data[offset + i] = StringVector::AddStringOrBlob(table_entry, conditions[i].table_name);
+        }
+        for (idx_t i = 0; i < conditions.size(); i++) {
+            SetContext(context_entry, offset + i, conditions[i].context);
         }
-
-        ListVector::SetListSize(result, new_size);
-        return list_entry_t(current_size, number_of_conditions);
     });
 }
 
 void RegisterParseWhereFunction(ExtensionLoader &loader) {
     TableFunction tf("parse_where", {LogicalType::VARCHAR}, ParseWhereFunction, ParseWhereBind, ParseWhereInit);
+    tf.projection_pushdown = true;
     loader.RegisterFunction(tf);
+
+    // parse_where_lateral is an in-out function that streams the conditions of a column of queries
+    TableFunction in_out("parse_where_lateral", {LogicalType::VARCHAR}, nullptr, ParseWhereInOutBind, ParseInOutInitGlobal, ParseInOutInitLocal<WhereConditionResult>);
+    in_out.in_out_function = ParseWhereInOutFunction;
+    loader.RegisterFunction(in_out);
 }
 
 void RegisterParseWhereScalarFunction(ExtensionLoader &loader) {
     auto return_type = LogicalType::LIST(LogicalType::STRUCT({
         {"condition", LogicalType::VARCHAR},
         {"table_name", LogicalType::VARCHAR},
-        {"context", LogicalType::VARCHAR}
+        {"context", ConditionContextType()}
     }));
-    ScalarFunction sf("parse_where", {LogicalType::VARCHAR}, return_type, ParseWhereScalarFunction);
-    loader.RegisterFunction(sf);
+    // the BLOB overload takes queries persisted with parse_to_blob
+    ScalarFunctionSet set("parse_where");
+    set.AddFunction(ParserToolsScalarFunction("parse_where", {LogicalType::VARCHAR}, return_type, ParseWhereScalarFunction));
+    set.AddFunction(ParserToolsScalarFunction("parse_where", {LogicalType::BLOB}, return_type, ParseWhereScalarFunction));
+    loader.RegisterFunction(set);
 }
 
 static string DetailedExpressionTypeToOperator(ExpressionType type) {
@@ -273,122 +293,194 @@ static string DetailedExpressionTypeToOperator(ExpressionType type) {
     }
 }
 
-static void ExtractDetailedWhereConditionsFromExpression(
-    const ParsedExpression &expr,
-    vector<DetailedWhereConditionResult> &results,
-    const string &context = "WHERE",
-    const string &table_name = ""
-) {
-    if (expr.type == ExpressionType::INVALID) return;
-
-    switch (expr.GetExpressionClass()) {
-        case ExpressionClass::CONJUNCTION: {
-            auto &conj = (ConjunctionExpression &)expr;
-            for (auto &child : conj.children) {
-                ExtractDetailedWhereConditionsFromExpression(*child, results, context, table_name);
-            }
-            break;
+// The base tables of a FROM clause by the name they are referred to with: their alias, or else their name
+struct FromTableAliases {
+    explicit FromTableAliases(const SelectNode &node) {
+        if (!node.from_table) {
+            return;
         }
-        case ExpressionClass::COMPARISON: {
-            auto &comp = (ComparisonExpression &)expr;
-            DetailedWhereConditionResult result;
-            result.context = context;
-            result.table_name = table_name;
-            
-            // Extract column name
-            if (comp.left->GetExpressionClass() == ExpressionClass::COLUMN_REF) {
-                auto &col_ref = (ColumnRefExpression &)*comp.left;
-                result.column_name = col_ref.GetColumnName();
+        vector<const TableRef *> pending {node.from_table.get()};
+        while (!pending.empty()) {
+            auto &ref = *pending.back();
+            pending.pop_back();
+            if (ref.type == TableReferenceType::JOIN) {
+                auto &join = (JoinRef &)ref;
+                pending.push_back(join.right.get());
+                pending.push_back(join.left.get());
+                continue;
             }
-            
-            // Extract operator
-            result.operator_type = DetailedExpressionTypeToOperator(comp.type);
-            
-            // Extract value
-            if (comp.right->GetExpressionClass() == ExpressionClass::CONSTANT) {
-                auto &const_expr = (ConstantExpression &)*comp.right;
-                result.value = const_expr.value.ToString();
-            } else {
-                result.value = comp.right->ToString();
+            source_count++;
+            if (ref.type == TableReferenceType::BASE_TABLE) {
+                auto &base = (BaseTableRef &)ref;
+                tables.emplace_back(base.alias.empty() ? base.table_name : base.alias, base.table_name);
+            } else if (!ref.alias.empty()) {
+                // subqueries and table functions have an alias but no base table
+                tables.emplace_back(ref.alias, string());
             }
-            
-            results.push_back(result);
-            break;
         }
-        case ExpressionClass::BETWEEN: {
-            auto &between = (BetweenExpression &)expr;
-            DetailedWhereConditionResult result;
-            result.context = context;
-            result.table_name = table_name;
-            
-            // Extract column name
-            if (between.input->GetExpressionClass() == ExpressionClass::COLUMN_REF) {
-                auto &col_ref = (ColumnRefExpression &)*between.input;
-                result.column_name = col_ref.GetColumnName();
+    }
+
+    // Resolves the table of a column: through its qualifier, or the single source of the FROM clause
+    bool Resolve(const ColumnRefExpression &column, string &alias, string &table) const {
+        if (column.column_names.size() >= 2) {
+            auto &qualifier = column.column_names[column.column_names.size() - 2];
+            for (auto &entry : tables) {
+                if (StringUtil::CIEquals(entry.first, qualifier)) {
+                    alias = entry.first;
+                    table = entry.second;
+                    return true;
+                }
             }
-            
-            // For BETWEEN, we'll create two conditions: >= lower AND <= upper
-            result.operator_type = ">=";
-            if (between.lower->GetExpressionClass() == ExpressionClass::CONSTANT) {
-                auto &const_expr = (ConstantExpression &)*between.lower;
-                result.value = const_expr.value.ToString();
-            } else {
-                result.value = between.lower->ToString();
+            // a qualifier from an outer query
+            alias = qualifier;
+            return true;
+        }
+        if (source_count == 1 && tables.size() == 1) {
+            alias = tables[0].first;
+            table = tables[0].second;
+            return true;
+        }
+        return false;
+    }
+
+    // (alias, base table; empty if the source is not a base table)
+    vector<std::pair<string, string>> tables;
+    idx_t source_count = 0;
+};
+
+// The constant of a comparison with its original type. Typed literals (DATE '2024-01-01', '5'::INTEGER) arrive as
+// a cast of a string constant and are cast here as the binder would
+static bool ExtractLiteral(const ParsedExpression &expr, Value &result) {
+    if (expr.GetExpressionClass() == ExpressionClass::CONSTANT) {
+        result = ((ConstantExpression &)expr).value;
+        return true;
+    }
+    if (expr.GetExpressionClass() == ExpressionClass::CAST) {
+        auto &cast = (CastExpression &)expr;
+        if (cast.try_cast || cast.child->GetExpressionClass() != ExpressionClass::CONSTANT ||
+            cast.cast_type.id() == LogicalTypeId::USER) {
+            return false;
+        }
+        auto value = ((ConstantExpression &)*cast.child).value;
+        if (!value.DefaultTryCastAs(cast.cast_type)) {
+            return false;
+        }
+        result = std::move(value);
+        return true;
+    }
+    return false;
+}
+
+// Fills the column and value side of a condition
+static void SetDetailedOperands(DetailedWhereConditionResult &result, const ParsedExpression &column,
+                                const ParsedExpression &value, const FromTableAliases &aliases) {
+    if (column.GetExpressionClass() == ExpressionClass::COLUMN_REF) {
+        auto &col_ref = (ColumnRefExpression &)column;
+        result.column_name = col_ref.GetColumnName();
+        result.qualified_column_name = StringUtil::Join(col_ref.column_names, ".");
+        aliases.Resolve(col_ref, result.table_alias, result.resolved_table);
+    }
+    if (value.GetExpressionClass() == ExpressionClass::CONSTANT) {
+        auto &const_expr = (ConstantExpression &)value;
+        result.value = const_expr.value.ToString();
+    } else {
+        result.value = value.ToString();
+    }
+    result.is_literal = ExtractLiteral(value, result.literal);
+}
+
+// The detailed counterpart of ExtractWhereConditionsFromExpression, with the same work-list over conjunctions
+static void ExtractDetailedWhereConditionsFromExpression(
+    const ParsedExpression &root,
+    vector<DetailedWhereConditionResult> &results,
+    const FromTableAliases &aliases,
+    ConditionContext context = ConditionContext::Where,
+    const string &table_name = ""
+) {
+    vector<const ParsedExpression *> pending {&root};
+    while (!pending.empty()) {
+        auto &expr = *pending.back();
+        pending.pop_back();
+        if (expr.type == ExpressionType::INVALID) continue;
+
+        switch (expr.GetExpressionClass()) {
+            case ExpressionClass::CONJUNCTION: {
+                auto &conj = (ConjunctionExpression &)expr;
+                for (idx_t i = conj.children.size(); i > 0; i--) {
+                    pending.push_back(conj.children[i - 1].get());
+                }
+                break;
             }
-            results.push_back(result);
-            
-            // Add the upper bound condition
-            DetailedWhereConditionResult upper_result = result;
-            upper_result.operator_type = "<=";
-            if (between.upper->GetExpressionClass() == ExpressionClass::CONSTANT) {
-                auto &const_expr = (ConstantExpression &)*between.upper;
-                upper_result.value = const_expr.value.ToString();
-            } else {
-                upper_result.value = between.upper->ToString();
+            case ExpressionClass::COMPARISON: {
+                auto &comp = (ComparisonExpression &)expr;
+                DetailedWhereConditionResult result;
+                result.context = context;
+                result.table_name = table_name;
+                result.operator_type = DetailedExpressionTypeToOperator(comp.type);
+                SetDetailedOperands(result, *comp.left, *comp.right, aliases);
+                results.push_back(std::move(result));
+                break;
             }
-            results.push_back(upper_result);
-            break;
-        }
-        case ExpressionClass::OPERATOR: {
-            auto &op = (OperatorExpression &)expr;
-            if (op.children.size() >= 2) {
+            case ExpressionClass::BETWEEN: {
+                // For BETWEEN, we'll create two conditions: >= lower AND <= upper
+                auto &between = (BetweenExpression &)expr;
                 DetailedWhereConditionResult result;
                 result.context = context;
                 result.table_name = table_name;
-                
-                // Extract column name
-                if (op.children[0]->GetExpressionClass() == ExpressionClass::COLUMN_REF) {
-                    auto &col_ref = (ColumnRefExpression &)*op.children[0];
-                    result.column_name = col_ref.GetColumnName();
-                }
-                
-                // Extract operator
-                result.operator_type = DetailedExpressionTypeToOperator(op.type);
-                
-                // Extract value
-                if (op.children[1]->GetExpressionClass() == ExpressionClass::CONSTANT) {
-                    auto &const_expr = (ConstantExpression &)*op.children[1];
-                    result.value = const_expr.value.ToString();
-                } else {
-                    result.value = op.children[1]->ToString();
-                }
-                
+                result.operator_type = ">=";
+                SetDetailedOperands(result, *between.input, *between.lower, aliases);
                 results.push_back(result);
+
+                result.operator_type = "<=";
+                SetDetailedOperands(result, *between.input, *between.upper, aliases);
+                results.push_back(std::move(result));
+                break;
+            }
+            case ExpressionClass::OPERATOR: {
+                auto &op = (OperatorExpression &)expr;
+                if (op.children.size() >= 2) {
+                    DetailedWhereConditionResult result;
+                    result.context = context;
+                    result.table_name = table_name;
+                    result.operator_type = DetailedExpressionTypeToOperator(op.type);
+                    SetDetailedOperands(result, *op.children[0], *op.children[1], aliases);
+                    results.push_back(std::move(result));
+                }
+                break;
             }
-            break;
+            default:
+                break;
         }
-        default:
-            break;
     }
 }
 
+// Reports the detailed WHERE and HAVING conditions of the root select node of each statement
+struct DetailedWhereCollector : public ASTCollector {
+    explicit DetailedWhereCollector(vector<DetailedWhereConditionResult> &results_p) : results(results_p) {
+    }
+
+    void VisitClause(const ParsedExpression &expr, FunctionContext clause, const SelectNode &node,
+                     const ASTWalkState &state) {
+        if (state.statement_root && (clause == FunctionContext::Where || clause == FunctionContext::Having)) {
+            FromTableAliases aliases(node);
+            ExtractDetailedWhereConditionsFromExpression(expr, results, aliases, clause == FunctionContext::Having ? ConditionContext::Having : ConditionContext::Where,
+                                                         GetConditionTableName(node));
+        }
+    }
+
+    vector<DetailedWhereConditionResult> &results;
+};
+
 struct ParseWhereDetailedState : public GlobalTableFunctionState {
     idx_t row = 0;
+    unique_ptr<CachedParser> parser;
     vector<DetailedWhereConditionResult> results;
+    ProjectedColumns projection;
 };
 
 struct ParseWhereDetailedBindData : public TableFunctionData {
     string sql;
+    ParserOptions options;
 };
 
 static unique_ptr<FunctionData> ParseWhereDetailedBind(ClientContext &context, 
@@ -402,20 +494,23 @@ static unique_ptr<FunctionData> ParseWhereDetailedBind(ClientContext &context,
         LogicalType::VARCHAR,  // operator_type
         LogicalType::VARCHAR,  // value
         LogicalType::VARCHAR,  // table_name
-        LogicalType::VARCHAR   // context
+        ConditionContextType()  // context
     };
     
     names = {"column_name", "operator_type", "value", "table_name", "context"};
     
     auto result = make_uniq<ParseWhereDetailedBindData>();
     result->sql = sql_input;
+    result->options = context.GetParserOptions();
 
     return std::move(result);
 }
 
 static unique_ptr<GlobalTableFunctionState> ParseWhereDetailedInit(ClientContext &context,
     TableFunctionInitInput &input) {
-    return make_uniq<ParseWhereDetailedState>();
+    auto state = make_uniq<ParseWhereDetailedState>();
+    state->projection = ProjectedColumns(input.column_ids);
+    return std::move(state);
 }
 
 static void ParseWhereDetailedFunction(ClientContext &context,
@@ -424,60 +519,153 @@ static void ParseWhereDetailedFunction(ClientContext &context,
     auto &state = (ParseWhereDetailedState &)*data.global_state;
     auto &bind_data = (ParseWhereDetailedBindData &)*data.bind_data;
 
-    if (state.results.empty() && state.row == 0) {
-        Parser parser;
-        try {
-            parser.ParseQuery(bind_data.sql);
-        } catch (const ParserException &ex) {
-            return;
-        }
+    if (!state.parser) {
+        state.parser = make_uniq<CachedParser>(context, bind_data.options, "parse_where_detailed");
+        auto parsed = state.parser->Parse(bind_data.sql);
+        StatsTimer timer(state.parser->Counters().walk_ns);
+        DetailedWhereCollector collector(state.results);
+        WalkStatements(parsed->statements, collector);
+        state.parser->Counters().rows += state.results.size();
+    }
 
-        for (auto &stmt : parser.statements) {
-            if (stmt->type == StatementType::SELECT_STATEMENT) {
-                auto &select_stmt = (SelectStatement &)*stmt;
-                if (select_stmt.node) {
-                    if (select_stmt.node->type == QueryNodeType::SELECT_NODE) {
-                        auto &select_node = (SelectNode &)*select_stmt.node;
-                        string table_name = "(empty)";  // Default table name
-                        
-                        // Try to extract table name from FROM clause
-                        if (select_node.from_table) {
-                            if (select_node.from_table->type == TableReferenceType::BASE_TABLE) {
-                                auto &base_table = (BaseTableRef &)*select_node.from_table;
-                                table_name = base_table.table_name;
-                            }
-                        }
-                        
-                        if (select_node.where_clause) {
-                            ExtractDetailedWhereConditionsFromExpression(*select_node.where_clause, state.results, "WHERE", table_name);
-                        }
-                        if (select_node.having) {
-                            ExtractDetailedWhereConditionsFromExpression(*select_node.having, state.results, "HAVING", table_name);
-                        }
-                    }
-                }
+    // fill the chunk up to STANDARD_VECTOR_SIZE, writing only the projected columns
+    auto count = MinValue<idx_t>(STANDARD_VECTOR_SIZE, state.results.size() - state.row);
+    auto &results = state.results;
+    state.projection.Write(output, state.row, count, state.parser->Counters(), [&](column_t column_id, Vector &vector, idx_t offset, idx_t count) -> bool {
+        if (column_id > 4) {
+            return false;
+        }
+        auto data = FlatVector::GetData<string_t>(vector);
+        for (idx_t i = 0; i < count; i++) {
+            auto &result = results[offset + i];
+            switch (column_id) {
+                case 0: data[i] = StringVector::AddString(vector, result.column_name); break;
+                case 1: data[i] = StringVector::AddString(vector, result.operator_type); break;
+                case 2: data[i] = StringVector::AddString(vector, result.value); break;
+                case 3: data[i] = StringVector::AddString(vector, result.table_name); break;
+                default: SetContext(vector, i, result.context); break;
             }
         }
+        return true;
+    });
+    state.row += count;
+}
+
+// The typed value of a condition: the union member matching the literal's type. Literals of other types are kept
+// as their text in the varchar member, `value_type` naming their type
+static LogicalType TypedValueType() {
+    return LogicalType::UNION({
+        {"boolean", LogicalType::BOOLEAN},
+        {"integer", LogicalType::BIGINT},
+        {"hugeint", LogicalType::HUGEINT},
+        {"double", LogicalType::DOUBLE},
+        {"decimal", LogicalType::DECIMAL(38, 18)},
+        {"varchar", LogicalType::VARCHAR},
+        {"date", LogicalType::DATE},
+        {"timestamp", LogicalType::TIMESTAMP}
+    });
+}
+
+static Value TypedValue(const LogicalType &union_type, const Value &literal) {
+    if (literal.IsNull()) {
+        return Value(union_type);
+    }
+    auto members = UnionType::CopyMemberTypes(union_type);
+    auto member = [&](uint8_t tag) -> Value {
+        return Value::UNION(members, tag, literal.DefaultCastAs(members[tag].second));
+    };
+    auto &type = literal.type();
+    switch (type.id()) {
+        case LogicalTypeId::BOOLEAN: return member(0);
+        case LogicalTypeId::TINYINT:
+        case LogicalTypeId::SMALLINT:
+        case LogicalTypeId::INTEGER:
+        case LogicalTypeId::BIGINT:
+        case LogicalTypeId::UTINYINT:
+        case LogicalTypeId::USMALLINT:
+        case LogicalTypeId::UINTEGER: return member(1);
+        case LogicalTypeId::UBIGINT:
+        case LogicalTypeId::HUGEINT: return member(2);
+        case LogicalTypeId::FLOAT:
+        case LogicalTypeId::DOUBLE: return member(3);
+        case LogicalTypeId::DECIMAL:
+            // exact if the decimal fits DECIMAL(38, 18), otherwise approximated
+            if (DecimalType::GetScale(type) <= 18 && DecimalType::GetWidth(type) - DecimalType::GetScale(type) <= 20) {
+                return member(4);
+            }
+            return member(3);
+        case LogicalTypeId::VARCHAR: return member(5);
+        case LogicalTypeId::DATE: return member(6);
+        case LogicalTypeId::TIMESTAMP: return member(7);
+        default: return Value::UNION(members, 5, Value(literal.ToString()));
     }
+}
 
-    if (state.row >= state.results.size()) {
-        return;
+static void SetOptionalString(Vector &vector, idx_t idx, const string &value) {
+    if (value.empty()) {
+        FlatVector::SetNull(vector, idx, true);
+    } else {
+        FlatVector::GetData<string_t>(vector)[idx] = StringVector::AddStringOrBlob(vector, value);
     }
+}
 
-    auto &result = state.results[state.row];
-    output.SetCardinality(1);
-    output.SetValue(0, 0, Value(result.column_name));
-    output.SetValue(1, 0, Value(result.operator_type));
-    output.SetValue(2, 0, Value(result.value));
-    output.SetValue(3, 0, Value(result.table_name));
-    output.SetValue(4, 0, Value(result.context));
+// Scalar counterpart of the table function, for columns of queries: one struct per condition with the qualified
+// column, the alias and base table it resolves to and the compared literal with its original type
+static void ParseWhereDetailedScalarFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+    auto &parser = ParserToolsLocalState::Get(state).parser;
+    ListResultBuilder<DetailedWhereConditionResult> builder(result, parser.Counters());
+    DeduplicatingExecutor::ExecuteWithNulls<list_entry_t>(args.data[0], result, args.size(),
+    [&builder, &parser](string_t query, bool &is_null) -> list_entry_t {
+        auto parsed = parser.Parse(query);
+        return builder.Append(parsed, is_null, [&](vector<DetailedWhereConditionResult> &conditions) {
+            DetailedWhereCollector collector(conditions);
+            WalkStatements(parsed->statements, collector);
+        });
+    });
 
-    state.row++;
+    builder.Finalize([](Vector &struct_vector, idx_t offset, const vector<DetailedWhereConditionResult> &conditions) {
+        auto &entries = StructVector::GetEntries(struct_vector);
+        for (idx_t i = 0; i < conditions.size(); i++) {
+            auto &condition = conditions[i];
+            auto idx = offset + i;
+            SetOptionalString(*entries[0], idx, condition.column_name);
+            SetOptionalString(*entries[1], idx, condition.qualified_column_name);
+            SetOptionalString(*entries[2], idx, condition.table_alias);
+            SetOptionalString(*entries[3], idx, condition.resolved_table);
+            SetOptionalString(*entries[4], idx, condition.operator_type);
+            SetOptionalString(*entries[5], idx, condition.value);
+            if (condition.is_literal) {
+                SetOptionalString(*entries[6], idx, condition.literal.type().ToString());
+                entries[7]->SetValue(idx, TypedValue(entries[7]->GetType(), condition.literal));
+            } else {
+                FlatVector::SetNull(*entries[6], idx, true);
+                FlatVector::SetNull(*entries[7], idx, true);
+            }
+            SetContext(*entries[8], idx, condition.context);
+        }
+    });
 }
 
 void RegisterParseWhereDetailedFunction(ExtensionLoader &loader) {
     TableFunction tf("parse_where_detailed", {LogicalType::VARCHAR}, ParseWhereDetailedFunction, ParseWhereDetailedBind, ParseWhereDetailedInit);
+    tf.projection_pushdown = true;
     loader.RegisterFunction(tf);
 }
 
-} // namespace duckdb 
+void RegisterParseWhereDetailedScalarFunction(ExtensionLoader &loader) {
+    auto return_type = LogicalType::LIST(LogicalType::STRUCT({
+        {"column_name", LogicalType::VARCHAR},
+        {"qualified_column_name", LogicalType::VARCHAR},
+        {"table_alias", LogicalType::VARCHAR},
+        {"table_name", LogicalType::VARCHAR},
+        {"operator_type", LogicalType::VARCHAR},
+        {"value", LogicalType::VARCHAR},
+        {"value_type", LogicalType::VARCHAR},
+        {"typed_value", TypedValueType()},
+        {"context", ConditionContextType()}
+    }));
+    auto sf = ParserToolsScalarFunction("parse_where_detailed", {LogicalType::VARCHAR}, return_type, ParseWhereDetailedScalarFunction);
+    loader.RegisterFunction(sf);
+}
+
+} // namespace duckdb
@@ -4,7 +4,16 @@
 #include "parse_tables.hpp"
 #include "parse_where.hpp"
 #include "parse_functions.hpp"
+#include "parse_columns.hpp"
+#include "parse_joins.hpp"
+#include "serialized_query.hpp"
+#include "parser_tools_stats.hpp"
 #include "parse_statements.hpp"
+#include "parse_all.hpp"
+#include "references_table.hpp"
+#include "sql_fingerprint.hpp"
+#include "usage_aggregates.hpp"
+#include "parse_cache.hpp"
 #include "duckdb.hpp"
 #include "duckdb/common/exception.hpp"
 #include "duckdb/common/string_util.hpp"
@@ -24,15 +33,25 @@ namespace duckdb {
 // EXTENSION SCAFFOLDING
 
 static void LoadInternal(ExtensionLoader &loader) {
+	RegisterParseCacheSettings(loader);
     RegisterParseTablesFunction(loader);
 	RegisterParseTableScalarFunction(loader);
 	RegisterParseWhereFunction(loader);
 	RegisterParseWhereScalarFunction(loader);
 	RegisterParseWhereDetailedFunction(loader);
+	RegisterParseWhereDetailedScalarFunction(loader);
 	RegisterParseFunctionsFunction(loader);
 	RegisterParseFunctionScalarFunction(loader);
+	RegisterParseColumnsFunction(loader);
+	RegisterParseJoinsFunction(loader);
+	RegisterParseToBlobFunction(loader);
+	RegisterParserToolsStatsFunctions(loader);
 	RegisterParseStatementsFunction(loader);
 	RegisterParseStatementsScalarFunction(loader);
+	RegisterParseAllScalarFunction(loader);
+	RegisterReferencesTableScalarFunction(loader);
+	RegisterSQLFingerprintScalarFunction(loader);
+	RegisterUsageAggregateFunctions(loader);
 }
 
 void ParserToolsExtension::Load(ExtensionLoader &loader) {
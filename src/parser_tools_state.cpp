@@ -0,0 +1,42 @@
+#include "parser_tools_state.hpp"
+#include "duckdb.hpp"
+#include "duckdb/execution/expression_executor_state.hpp"
+#include "duckdb/planner/expression/bound_function_expression.hpp"
+
+namespace duckdb {
+
+unique_ptr<FunctionData> ParserToolsBindData::Copy() const {
+	return make_uniq<ParserToolsBindData>(options);
+}
+
+bool ParserToolsBindData::Equals(const FunctionData &other_p) const {
+	auto &other = other_p.Cast<ParserToolsBindData>();
+	return options.preserve_identifier_case == other.options.preserve_identifier_case &&
+	       options.integer_division == other.options.integer_division &&
+	       options.max_expression_depth == other.options.max_expression_depth;
+}
+
+ParserToolsLocalState &ParserToolsLocalState::Get(ExpressionState &state) {
+	return ExecuteFunctionState::GetFunctionState(state)->Cast<ParserToolsLocalState>();
+}
+
+static unique_ptr<FunctionData> ParserToolsBind(ClientContext &context, ScalarFunction &bound_function,
+                                                vector<unique_ptr<Expression>> &arguments) {
+	return make_uniq<ParserToolsBindData>(context.GetParserOptions());
+}
+
+static unique_ptr<FunctionLocalState> ParserToolsInitLocal(ExpressionState &state, const BoundFunctionExpression &expr,
+                                                           FunctionData *bind_data) {
+	auto &data = bind_data->Cast<ParserToolsBindData>();
+	return make_uniq<ParserToolsLocalState>(state.GetContext(), data.options, expr.function.name);
+}
+
+ScalarFunction ParserToolsScalarFunction(const string &name, vector<LogicalType> arguments, LogicalType return_type,
+                                         scalar_function_t function) {
+	ScalarFunction result(name, std::move(arguments), std::move(return_type), function);
+	result.bind = ParserToolsBind;
+	result.init_local_state = ParserToolsInitLocal;
+	return result;
+}
+
+} // namespace duckdb
@@ -0,0 +1,112 @@
+#include "parser_tools_stats.hpp"
+#include "duckdb.hpp"
+
+namespace duckdb {
+
+void ParserToolsCounters::Add(const ParserToolsCounters &other) {
+	calls += other.calls;
+	rows += other.rows;
+	input_bytes += other.input_bytes;
+	parse_failures += other.parse_failures;
+	cache_hits += other.cache_hits;
+	cache_misses += other.cache_misses;
+	parse_ns += other.parse_ns;
+	walk_ns += other.walk_ns;
+	materialize_ns += other.materialize_ns;
+}
+
+shared_ptr<ParserToolsStats> ParserToolsStats::Get(ClientContext &context) {
+	return ObjectCache::GetObjectCache(context).GetOrCreate<ParserToolsStats>(ObjectType());
+}
+
+void ParserToolsStats::Flush(const string &function_name, const ParserToolsCounters &counters) {
+	lock_guard<mutex> guard(lock);
+	totals[function_name].Add(counters);
+}
+
+std::map<string, ParserToolsCounters> ParserToolsStats::Snapshot() {
+	lock_guard<mutex> guard(lock);
+	return totals;
+}
+
+std::map<string, ParserToolsCounters> ParserToolsStats::Reset() {
+	lock_guard<mutex> guard(lock);
+	std::map<string, ParserToolsCounters> result;
+	result.swap(totals);
+	return result;
+}
+
+// Table functions
+// ---------------------------------------------------
+
+struct ParserToolsStatsState : public GlobalTableFunctionState {
+	vector<std::pair<string, ParserToolsCounters>> rows;
+	idx_t row = 0;
+};
+
+static unique_ptr<FunctionData> ParserToolsStatsBind(ClientContext &context, TableFunctionBindInput &input,
+                                                     vector<LogicalType> &return_types, vector<string> &names) {
+	names = {"function_name", "calls",        "rows",     "input_bytes", "parse_failures",
+	         "cache_hits",    "cache_misses", "parse_ns", "walk_ns",     "materialize_ns"};
+	return_types = {LogicalType::VARCHAR};
+	for (idx_t i = 1; i < names.size(); i++) {
+		return_types.push_back(LogicalType::UBIGINT);
+	}
+	return make_uniq<TableFunctionData>();
+}
+
+static unique_ptr<GlobalTableFunctionState> ParserToolsStatsInit(ClientContext &context,
+                                                                TableFunctionInitInput &input) {
+	auto state = make_uniq<ParserToolsStatsState>();
+	for (auto &entry : ParserToolsStats::Get(context)->Snapshot()) {
+		state->rows.push_back(entry);
+	}
+	return std::move(state);
+}
+
+static unique_ptr<GlobalTableFunctionState> ParserToolsResetStatsInit(ClientContext &context,
+                                                                     TableFunctionInitInput &input) {
+	auto state = make_uniq<ParserToolsStatsState>();
+	// the totals up to the reset, so that periodic readers lose nothing in between
+	for (auto &entry : ParserToolsStats::Get(context)->Reset()) {
+		state->rows.push_back(entry);
+	}
+	return std::move(state);
+}
+
+static void ParserToolsStatsFunction(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+	auto &state = (ParserToolsStatsState &)*data.global_state;
+	idx_t count = 0;
+	while (state.row < state.rows.size() && count < STANDARD_VECTOR_SIZE) {
+		auto &entry = state.rows[state.row++];
+		auto &counters = entry.second;
+		output.SetValue(0, count, Value(entry.first));
+		output.SetValue(1, count, Value::UBIGINT(counters.calls));
+		output.SetValue(2, count, Value::UBIGINT(counters.rows));
+		output.SetValue(3, count, Value::UBIGINT(counters.input_bytes));
+		output.SetValue(4, count, Value::UBIGINT(counters.parse_failures));
+		output.SetValue(5, count, Value::UBIGINT(counters.cache_hits));
+		output.SetValue(6, count, Value::UBIGINT(counters.cache_misses));
+		output.SetValue(7, count, Value::UBIGINT(counters.parse_ns));
+		output.SetValue(8, count, Value::UBIGINT(counters.walk_ns));
+		output.SetValue(9, count, Value::UBIGINT(counters.materialize_ns));
+		count++;
+	}
+	output.SetCardinality(count);
+}
+
+// Extension scaffolding
+// ---------------------------------------------------
+
+void RegisterParserToolsStatsFunctions(ExtensionLoader &loader) {
+	// parser_tools_stats() returns the totals per function of the queries that have finished
+	TableFunction stats("parser_tools_stats", {}, ParserToolsStatsFunction, ParserToolsStatsBind, ParserToolsStatsInit);
+	loader.RegisterFunction(stats);
+
+	// parser_tools_reset_stats() returns the same and clears the totals
+	TableFunction reset("parser_tools_reset_stats", {}, ParserToolsStatsFunction, ParserToolsStatsBind,
+	                    ParserToolsResetStatsInit);
+	loader.RegisterFunction(reset);
+}
+
+} // namespace duckdb
@@ -0,0 +1,257 @@
+#include "references_table.hpp"
+#include "ast_walker.hpp"
+#include "parse_cache.hpp"
+#include "parser_tools_state.hpp"
+#include "deduplicating_executor.hpp"
+#include "duckdb.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/execution/expression_executor.hpp"
+#include "duckdb/planner/expression/bound_function_expression.hpp"
+#include <unordered_set>
+
+namespace duckdb {
+
+// The tables a references_table / references_any_table call looks for.
+// A name is either a bare table name, matching the table in any schema, or "schema.table";
+// unqualified references in the query belong to the default schema.
+struct TableNameSet {
+	unordered_set<string> tables;
+	unordered_set<string> qualified_tables;
+
+	void Add(const string &name, bool case_sensitive) {
+		auto normalized = case_sensitive ? name : StringUtil::Lower(name);
+		if (normalized.find('.') == string::npos) {
+			tables.insert(std::move(normalized));
+		} else {
+			qualified_tables.insert(std::move(normalized));
+		}
+	}
+
+	bool Matches(const BaseTableRef &ref, bool case_sensitive) const {
+		auto table = case_sensitive ? ref.table_name : StringUtil::Lower(ref.table_name);
+		if (tables.find(table) != tables.end()) {
+			return true;
+		}
+		if (qualified_tables.empty()) {
+			return false;
+		}
+		string schema = ref.schema_name.empty() ? string(DEFAULT_SCHEMA_NAME) : ref.schema_name;
+		auto qualified = (case_sensitive ? schema : StringUtil::Lower(schema)) + "." + table;
+		return qualified_tables.find(qualified) != qualified_tables.end();
+	}
+
+	bool operator==(const TableNameSet &other) const {
+		return tables == other.tables && qualified_tables == other.qualified_tables;
+	}
+};
+
+// Stops the walk at the first base table that is one of the targets. References to CTEs are not tables
+struct TableMatchCollector : public ASTCollector {
+	static constexpr bool VISIT_TABLE_REFS = true;
+
+	TableMatchCollector(const TableNameSet &targets_p, bool case_sensitive_p)
+	    : targets(targets_p), case_sensitive(case_sensitive_p) {
+	}
+
+	bool IsDone() const {
+		return found;
+	}
+
+	void VisitBaseTable(const BaseTableRef &ref, TableContext context, const ASTWalkState &state) {
+		if (context != TableContext::FromCTE && targets.Matches(ref, case_sensitive)) {
+			found = true;
+		}
+	}
+
+	const TableNameSet &targets;
+	const bool case_sensitive;
+	bool found = false;
+};
+
+// The walk is added to the walk time of `counters`, and its answer counts as one result
+static bool ReferencesAnyTable(const ParsedQuery &parsed, const TableNameSet &targets, bool case_sensitive,
+                               ParserToolsCounters &counters) {
+	counters.rows++;
+	if (targets.tables.empty() && targets.qualified_tables.empty()) {
+		return false;
+	}
+	StatsTimer timer(counters.walk_ns);
+	TableMatchCollector collector(targets, case_sensitive);
+	WalkStatements(parsed.statements, collector);
+	return collector.found;
+}
+
+struct ReferencesTableBindData : public ParserToolsBindData {
+	ReferencesTableBindData(ParserOptions options_p, bool case_sensitive_p)
+	    : ParserToolsBindData(std::move(options_p)), case_sensitive(case_sensitive_p) {
+	}
+
+	bool case_sensitive;
+	// true if the target argument is constant: the targets are then resolved once here instead of per row
+	bool constant_targets = false;
+	bool null_targets = false;
+	TableNameSet targets;
+
+	unique_ptr<FunctionData> Copy() const override {
+		return make_uniq<ReferencesTableBindData>(*this);
+	}
+
+	bool Equals(const FunctionData &other_p) const override {
+		if (!ParserToolsBindData::Equals(other_p)) {
+			return false;
+		}
+		auto &other = other_p.Cast<ReferencesTableBindData>();
+		return case_sensitive == other.case_sensitive && constant_targets == other.constant_targets &&
+		       null_targets == other.null_targets && targets == other.targets;
+	}
+};
+
+static void AddTargets(TableNameSet &targets, const Value &value, bool case_sensitive) {
+	if (value.type().id() == LogicalTypeId::LIST) {
+		for (auto &child : ListValue::GetChildren(value)) {
+			if (!child.IsNull()) {
+				targets.Add(StringValue::Get(child), case_sensitive);
+			}
+		}
+	} else {
+		targets.Add(StringValue::Get(value), case_sensitive);
+	}
+}
+
+static unique_ptr<FunctionData> ReferencesTableBind(ClientContext &context, ScalarFunction &bound_function,
+                                                    vector<unique_ptr<Expression>> &arguments) {
+	bool case_sensitive = false;
+	if (arguments.size() == 3) {
+		if (!arguments[2]->IsFoldable()) {
+			throw BinderException("%s: case_sensitive must be a constant", bound_function.name);
+		}
+		auto value = ExpressionExecutor::EvaluateScalar(context, *arguments[2]);
+		case_sensitive = !value.IsNull() && BooleanValue::Get(value.DefaultCastAs(LogicalType::BOOLEAN));
+	}
+	auto result = make_uniq<ReferencesTableBindData>(context.GetParserOptions(), case_sensitive);
+	if (arguments[1]->IsFoldable()) {
+		auto value = ExpressionExecutor::EvaluateScalar(context, *arguments[1]);
+		result->constant_targets = true;
+		if (value.IsNull()) {
+			result->null_targets = true;
+		} else {
+			AddTargets(result->targets, value.DefaultCastAs(bound_function.arguments[1]), case_sensitive);
+		}
+	}
+	return std::move(result);
+}
+
+static void ReferencesTableFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &func_expr = state.expr.Cast<BoundFunctionExpression>();
+	auto &data = func_expr.bind_info->Cast<ReferencesTableBindData>();
+	auto &parser = ParserToolsLocalState::Get(state).parser;
+
+	if (data.constant_targets) {
+		if (data.null_targets) {
+			result.SetVectorType(VectorType::CONSTANT_VECTOR);
+			ConstantVector::SetNull(result, true);
+			return;
+		}
+		// the common case: a fixed set of tables, matched against each distinct query of the chunk once
+		DeduplicatingExecutor::ExecuteWithNulls<bool>(args.data[0], result, args.size(),
+		                                              [&](string_t query, bool &is_null) -> bool {
+			                                              auto parsed = parser.Parse(query, ParseTarget::Tables);
+			                                              if (parsed->SkippedByLimit()) {
+				                                              // unknown
+				                                              is_null = true;
+				                                              return false;
+			                                              }
+			                                              return ReferencesAnyTable(*parsed, data.targets,
+			                                                                        data.case_sensitive,
+			                                                                        parser.Counters());
+		                                              });
+		return;
+	}
+
+	// the targets vary per row: resolve them for every row
+	auto count = args.size();
+	auto &target_vector = args.data[1];
+	bool list_targets = target_vector.GetType().id() == LogicalTypeId::LIST;
+
+	UnifiedVectorFormat sql_format;
+	args.data[0].ToUnifiedFormat(count, sql_format);
+	auto sql_data = UnifiedVectorFormat::GetData<string_t>(sql_format);
+	UnifiedVectorFormat target_format;
+	target_vector.ToUnifiedFormat(count, target_format);
+
+	UnifiedVectorFormat child_format;
+	const string_t *child_data = nullptr;
+	if (list_targets) {
+		auto &child = ListVector::GetEntry(target_vector);
+		child.ToUnifiedFormat(ListVector::GetListSize(target_vector), child_format);
+		child_data = UnifiedVectorFormat::GetData<string_t>(child_format);
+	}
+
+	result.SetVectorType(VectorType::FLAT_VECTOR);
+	auto result_data = FlatVector::GetData<bool>(result);
+	auto &result_validity = FlatVector::Validity(result);
+
+	TableNameSet targets;
+	for (idx_t i = 0; i < count; i++) {
+		auto sql_idx = sql_format.sel->get_index(i);
+		auto target_idx = target_format.sel->get_index(i);
+		if (!sql_format.validity.RowIsValid(sql_idx) || !target_format.validity.RowIsValid(target_idx)) {
+			result_validity.SetInvalid(i);
+			continue;
+		}
+		targets.tables.clear();
+		targets.qualified_tables.clear();
+		if (list_targets) {
+			auto &entry = UnifiedVectorFormat::GetData<list_entry_t>(target_format)[target_idx];
+			for (idx_t j = entry.offset; j < entry.offset + entry.length; j++) {
+				auto child_idx = child_format.sel->get_index(j);
+				if (child_format.validity.RowIsValid(child_idx)) {
+					targets.Add(child_data[child_idx].GetString(), data.case_sensitive);
+				}
+			}
+		} else {
+			targets.Add(UnifiedVectorFormat::GetData<string_t>(target_format)[target_idx].GetString(),
+			            data.case_sensitive);
+		}
+		auto parsed = parser.Parse(sql_data[sql_idx], ParseTarget::Tables);
+		if (parsed->SkippedByLimit()) {
+			result_validity.SetInvalid(i);
+			continue;
+		}
+		result_data[i] = ReferencesAnyTable(*parsed, targets, data.case_sensitive, parser.Counters());
+	}
+	if (args.AllConstant()) {
+		result.SetVectorType(VectorType::CONSTANT_VECTOR);
+	}
+}
+
+static ScalarFunction ReferencesTableScalarFunction(const string &name, vector<LogicalType> arguments) {
+	auto function = ParserToolsScalarFunction(name, std::move(arguments), LogicalType::BOOLEAN, ReferencesTableFunction);
+	function.bind = ReferencesTableBind;
+	return function;
+}
+
+// Extension scaffolding
+// ---------------------------------------------------
+
+void RegisterReferencesTableScalarFunction(ExtensionLoader &loader) {
+	// references_table(sql_query, table_name [, case_sensitive]) is true if the query reads from the table.
+	// The walk stops at the first match, so it is much cheaper than list_contains(parse_table_names(...), ...)
+	ScalarFunctionSet references_table("references_table");
+	references_table.AddFunction(
+	    ReferencesTableScalarFunction("references_table", {LogicalType::VARCHAR, LogicalType::VARCHAR}));
+	references_table.AddFunction(ReferencesTableScalarFunction(
+	    "references_table", {LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::BOOLEAN}));
+	loader.RegisterFunction(references_table);
+
+	// references_any_table(sql_query, table_names [, case_sensitive]) is true if the query reads from any of them
+	auto names_type = LogicalType::LIST(LogicalType::VARCHAR);
+	ScalarFunctionSet references_any_table("references_any_table");
+	references_any_table.AddFunction(
+	    ReferencesTableScalarFunction("references_any_table", {LogicalType::VARCHAR, names_type}));
+	references_any_table.AddFunction(ReferencesTableScalarFunction(
+	    "references_any_table", {LogicalType::VARCHAR, names_type, LogicalType::BOOLEAN}));
+	loader.RegisterFunction(references_any_table);
+}
+
+} // namespace duckdb
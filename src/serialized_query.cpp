@@ -0,0 +1,157 @@
+#include "serialized_query.hpp"
+#include "parser_tools_state.hpp"
+#include "duckdb.hpp"
+#include "duckdb/common/error_data.hpp"
+#include "duckdb/common/serializer/binary_deserializer.hpp"
+#include "duckdb/common/serializer/binary_serializer.hpp"
+#include "duckdb/common/serializer/memory_stream.hpp"
+#include "duckdb/parser/parser.hpp"
+#include "duckdb/parser/statement/select_statement.hpp"
+
+namespace duckdb {
+
+// Prefix of every parse_to_blob value, followed by the binary serialization. Bump the version when the layout
+// of the statements changes
+static constexpr const char SERIALIZED_QUERY_MAGIC[] = {'P', 'T', 'A', 'S'};
+static constexpr idx_t SERIALIZED_QUERY_MAGIC_SIZE = sizeof(SERIALIZED_QUERY_MAGIC);
+static constexpr uint32_t SERIALIZED_QUERY_VERSION = 1;
+
+// Writes the blob; with `serialize_selects` false every statement is stored as text only
+static string SerializeStatements(const ParsedQuery &parsed, const char *sql, idx_t size, bool serialize_selects) {
+	MemoryStream stream;
+	stream.WriteData(const_data_ptr_cast(SERIALIZED_QUERY_MAGIC), SERIALIZED_QUERY_MAGIC_SIZE);
+	BinarySerializer serializer(stream);
+	serializer.Begin();
+	serializer.WriteProperty<uint32_t>(100, "version", SERIALIZED_QUERY_VERSION);
+	serializer.WriteProperty<string>(101, "sql", string(sql, size));
+	vector<const SQLStatement *> statements;
+	for (auto &stmt : parsed.statements) {
+		if (stmt) {
+			statements.push_back(stmt.get());
+		}
+	}
+	serializer.WriteList(102, "statements", statements.size(), [&](Serializer::List &list, idx_t i) {
+		auto &stmt = *statements[i];
+		list.WriteObject([&](Serializer &object) {
+			object.WriteProperty<idx_t>(100, "stmt_location", stmt.stmt_location);
+			object.WriteProperty<idx_t>(101, "stmt_length", stmt.stmt_length);
+			bool has_select = serialize_selects && stmt.type == StatementType::SELECT_STATEMENT;
+			object.WriteProperty<bool>(102, "has_select", has_select);
+			if (has_select) {
+				object.WriteObject(103, "select", [&](Serializer &select) {
+					((const SelectStatement &)stmt).Serialize(select);
+				});
+			}
+		});
+	});
+	serializer.End();
+	return string((const char *)stream.GetData(), stream.GetPosition());
+}
+
+string SerializeParsedQuery(const ParsedQuery &parsed, const char *sql, idx_t size) {
+	try {
+		return SerializeStatements(parsed, sql, size, true);
+	} catch (const std::exception &) {
+		// a tree with a node the serializer does not support: keep the text, to be re-parsed when loaded
+		return SerializeStatements(parsed, sql, size, false);
+	}
+}
+
+static shared_ptr<ParsedQuery> InvalidSerializedQuery(const string &reason) {
+	auto result = make_shared_ptr<ParsedQuery>();
+	result->error = "Invalid parse_to_blob value: " + reason;
+	return result;
+}
+
+// Parses the text of a statement that was stored without its tree, at its location in the query
+static void ParseStatementText(Parser &parser, const string &sql, idx_t location, idx_t length,
+                               vector<unique_ptr<SQLStatement>> &statements) {
+	location = MinValue<idx_t>(location, sql.size());
+	length = length == 0 ? sql.size() - location : MinValue<idx_t>(length, sql.size() - location);
+	parser.statements.clear();
+	parser.ParseQuery(sql.substr(location, length));
+	for (auto &stmt : parser.statements) {
+		stmt->stmt_location += location;
+		statements.push_back(std::move(stmt));
+	}
+	parser.statements.clear();
+}
+
+shared_ptr<ParsedQuery> DeserializeParsedQuery(const ParserOptions &options, const char *data, idx_t size) {
+	if (size < SERIALIZED_QUERY_MAGIC_SIZE || memcmp(data, SERIALIZED_QUERY_MAGIC, SERIALIZED_QUERY_MAGIC_SIZE) != 0) {
+		return InvalidSerializedQuery("not a serialized query");
+	}
+	auto result = make_shared_ptr<ParsedQuery>();
+	try {
+		MemoryStream stream((data_ptr_t)(data + SERIALIZED_QUERY_MAGIC_SIZE), size - SERIALIZED_QUERY_MAGIC_SIZE);
+		BinaryDeserializer deserializer(stream);
+		deserializer.Begin();
+		auto version = deserializer.ReadProperty<uint32_t>(100, "version");
+		if (version != SERIALIZED_QUERY_VERSION) {
+			return InvalidSerializedQuery("unsupported version " + to_string(version));
+		}
+		result->sql = deserializer.ReadProperty<string>(101, "sql");
+		Parser parser(options);
+		deserializer.ReadList(102, "statements", [&](Deserializer::List &list, idx_t i) {
+			list.ReadObject([&](Deserializer &object) {
+				auto location = object.ReadProperty<idx_t>(100, "stmt_location");
+				auto length = object.ReadProperty<idx_t>(101, "stmt_length");
+				if (!object.ReadProperty<bool>(102, "has_select")) {
+					ParseStatementText(parser, result->sql, location, length, result->statements);
+					return;
+				}
+				unique_ptr<SQLStatement> stmt;
+				object.ReadObject(103, "select", [&](Deserializer &select) { stmt = SelectStatement::Deserialize(select); });
+				stmt->stmt_location = location;
+				stmt->stmt_length = length;
+				result->statements.push_back(std::move(stmt));
+			});
+		});
+		deserializer.End();
+	} catch (const std::exception &ex) {
+		ErrorData error(ex);
+		return InvalidSerializedQuery(error.RawMessage());
+	}
+	result->success = true;
+	return result;
+}
+
+// parse_to_blob(sql_query): the parse of the query as a BLOB, NULL if the query does not parse
+static void ParseToBlobScalarFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &parser = ParserToolsLocalState::Get(state).parser;
+	auto count = args.size();
+
+	UnifiedVectorFormat sql_format;
+	args.data[0].ToUnifiedFormat(count, sql_format);
+	auto sql_data = UnifiedVectorFormat::GetData<string_t>(sql_format);
+
+	auto result_data = FlatVector::GetData<string_t>(result);
+	auto &result_validity = FlatVector::Validity(result);
+	for (idx_t i = 0; i < count; i++) {
+		auto idx = sql_format.sel->get_index(i);
+		if (!sql_format.validity.RowIsValid(idx)) {
+			result_validity.SetInvalid(i);
+			continue;
+		}
+		auto &sql = sql_data[idx];
+		auto parsed = parser.Parse(sql);
+		if (!parsed->success) {
+			result_validity.SetInvalid(i);
+			continue;
+		}
+		result_data[i] = StringVector::AddStringOrBlob(result, SerializeParsedQuery(*parsed, sql.GetData(), sql.GetSize()));
+	}
+	if (args.AllConstant()) {
+		result.SetVectorType(VectorType::CONSTANT_VECTOR);
+	}
+}
+
+// Extension scaffolding
+// ---------------------------------------------------
+
+void RegisterParseToBlobFunction(ExtensionLoader &loader) {
+	loader.RegisterFunction(
+	    ParserToolsScalarFunction("parse_to_blob", {LogicalType::VARCHAR}, LogicalType::BLOB, ParseToBlobScalarFunction));
+}
+
+} // namespace duckdb
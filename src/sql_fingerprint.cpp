@@ -0,0 +1,687 @@
+#include "sql_fingerprint.hpp"
+#include "parse_cache.hpp"
+#include "parser_tools_state.hpp"
+#include "duckdb.hpp"
+#include "duckdb/common/types/hash.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/parser/parsed_expression_iterator.hpp"
+#include "duckdb/parser/expression/cast_expression.hpp"
+#include "duckdb/parser/expression/collate_expression.hpp"
+#include "duckdb/parser/expression/columnref_expression.hpp"
+#include "duckdb/parser/expression/function_expression.hpp"
+#include "duckdb/parser/expression/operator_expression.hpp"
+#include "duckdb/parser/expression/parameter_expression.hpp"
+#include "duckdb/parser/expression/positional_reference_expression.hpp"
+#include "duckdb/parser/expression/star_expression.hpp"
+#include "duckdb/parser/expression/subquery_expression.hpp"
+#include "duckdb/parser/expression/window_expression.hpp"
+#include "duckdb/parser/query_node/select_node.hpp"
+#include "duckdb/parser/query_node/cte_node.hpp"
+#include "duckdb/parser/query_node/recursive_cte_node.hpp"
+#include "duckdb/parser/query_node/set_operation_node.hpp"
+#include "duckdb/parser/result_modifier.hpp"
+#include "duckdb/parser/statement/select_statement.hpp"
+#include "duckdb/parser/statement/insert_statement.hpp"
+#include "duckdb/parser/statement/update_statement.hpp"
+#include "duckdb/parser/statement/delete_statement.hpp"
+#include "duckdb/parser/tableref/basetableref.hpp"
+#include "duckdb/parser/tableref/expressionlistref.hpp"
+#include "duckdb/parser/tableref/joinref.hpp"
+#include "duckdb/parser/tableref/pivotref.hpp"
+#include "duckdb/parser/tableref/showref.hpp"
+#include "duckdb/parser/tableref/subqueryref.hpp"
+#include "duckdb/parser/tableref/table_function_ref.hpp"
+
+namespace duckdb {
+
+// Normalization
+// ---------------------------------------------------
+
+namespace {
+
+class QueryNormalizer {
+public:
+	void NormalizeStatement(SQLStatement &stmt) {
+		switch (stmt.type) {
+		case StatementType::SELECT_STATEMENT: {
+			auto &select = (SelectStatement &)stmt;
+			NormalizeQueryNode(select.node);
+			break;
+		}
+		case StatementType::INSERT_STATEMENT: {
+			// VALUES lists are a select statement as well
+			auto &insert = (InsertStatement &)stmt;
+			if (insert.select_statement) {
+				NormalizeQueryNode(insert.select_statement->node);
+			}
+			break;
+		}
+		case StatementType::UPDATE_STATEMENT: {
+			auto &update = (UpdateStatement &)stmt;
+			if (update.set_info) {
+				for (auto &expr : update.set_info->expressions) {
+					NormalizeExpression(expr);
+				}
+				NormalizeExpression(update.set_info->condition);
+			}
+			break;
+		}
+		case StatementType::DELETE_STATEMENT: {
+			auto &del = (DeleteStatement &)stmt;
+			NormalizeExpression(del.condition);
+			break;
+		}
+		default:
+			// the literals of other statements (SET, PRAGMA, ...) are part of their shape
+			break;
+		}
+	}
+
+private:
+	void NormalizeQueryNode(unique_ptr<QueryNode> &node) {
+		if (!node) {
+			return;
+		}
+		// all expressions of the node: clauses, modifiers, CTEs, joins and subqueries in the FROM clause
+		ParsedExpressionIterator::EnumerateQueryNodeChildren(
+		    *node, [&](unique_ptr<ParsedExpression> &child) { NormalizeExpression(child); });
+	}
+
+	static bool IsLiteral(const ParsedExpression &expr) {
+		return expr.GetExpressionClass() == ExpressionClass::CONSTANT ||
+		       expr.GetExpressionClass() == ExpressionClass::PARAMETER;
+	}
+
+	void NormalizeExpression(unique_ptr<ParsedExpression> &expr) {
+		if (!expr) {
+			return;
+		}
+		switch (expr->GetExpressionClass()) {
+		case ExpressionClass::CONSTANT:
+		case ExpressionClass::PARAMETER: {
+			auto placeholder = make_uniq<ParameterExpression>();
+			placeholder->identifier = to_string(++placeholder_count);
+			expr = std::move(placeholder);
+			return;
+		}
+		case ExpressionClass::OPERATOR: {
+			auto &op = (OperatorExpression &)*expr;
+			if ((op.type == ExpressionType::COMPARE_IN || op.type == ExpressionType::COMPARE_NOT_IN) &&
+			    op.children.size() > 2) {
+				// x IN (1, 2, 3) has the shape of x IN (1)
+				bool all_literals = true;
+				for (idx_t i = 1; i < op.children.size(); i++) {
+					all_literals = all_literals && IsLiteral(*op.children[i]);
+				}
+				if (all_literals) {
+					op.children.erase(op.children.begin() + 2, op.children.end());
+				}
+			}
+			break;
+		}
+		case ExpressionClass::SUBQUERY: {
+			// the iterator only visits the left-hand side of e.g. x IN (SELECT ...)
+			auto &subquery = (SubqueryExpression &)*expr;
+			if (subquery.subquery) {
+				NormalizeQueryNode(subquery.subquery->node);
+			}
+			break;
+		}
+		default:
+			break;
+		}
+		ParsedExpressionIterator::EnumerateChildren(
+		    *expr, [&](unique_ptr<ParsedExpression> &child) { NormalizeExpression(child); });
+	}
+
+	idx_t placeholder_count = 0;
+};
+
+} // namespace
+
+void NormalizeStatements(vector<unique_ptr<SQLStatement>> &statements) {
+	// placeholders are numbered across the whole script
+	QueryNormalizer normalizer;
+	for (auto &stmt : statements) {
+		if (stmt) {
+			normalizer.NormalizeStatement(*stmt);
+		}
+	}
+}
+
+// Fingerprinting
+// ---------------------------------------------------
+
+namespace {
+
+// Combines the hashes of the statements as sql_normalize would normalize them, without normalizing: literals and
+// parameters hash as a placeholder, and an IN list of literals as a single one. The tree is only read, as it may be
+// shared through the parse cache. Statements, query nodes, table refs and expressions are hashed structurally, with
+// a marker per clause so that an expression hashes differently in SELECT and in WHERE. Only the statements other than
+// SELECT, INSERT, UPDATE and DELETE, whose literals are part of their shape, are hashed from their rendering.
+class FingerprintHasher {
+public:
+	void HashStatement(const SQLStatement &stmt) {
+		Combine(duckdb::Hash<uint8_t>(static_cast<uint8_t>(stmt.type)));
+		switch (stmt.type) {
+		case StatementType::SELECT_STATEMENT: {
+			auto &select = (const SelectStatement &)stmt;
+			HashQueryNode(select.node.get());
+			break;
+		}
+		case StatementType::INSERT_STATEMENT: {
+			auto &insert = (const InsertStatement &)stmt;
+			HashCTEs(insert.cte_map);
+			HashName(insert.catalog);
+			HashName(insert.schema);
+			HashName(insert.table);
+			HashNames(insert.columns);
+			Combine(duckdb::Hash<uint8_t>(static_cast<uint8_t>(insert.column_order)));
+			Combine(duckdb::Hash<bool>(insert.default_values));
+			// VALUES lists are a select statement as well
+			HashQueryNode(insert.select_statement ? insert.select_statement->node.get() : nullptr);
+			if (insert.on_conflict_info) {
+				auto &on_conflict = *insert.on_conflict_info;
+				Combine(duckdb::Hash<uint8_t>(static_cast<uint8_t>(on_conflict.action_type)));
+				HashNames(on_conflict.indexed_columns);
+				HashExpression(on_conflict.condition.get());
+				HashUpdateSetInfo(on_conflict.set_info.get());
+			}
+			HashExpressions(insert.returning_list);
+			break;
+		}
+		case StatementType::UPDATE_STATEMENT: {
+			auto &update = (const UpdateStatement &)stmt;
+			HashCTEs(update.cte_map);
+			HashOptionalTableRef(update.table.get());
+			HashOptionalTableRef(update.from_table.get());
+			HashUpdateSetInfo(update.set_info.get());
+			HashExpressions(update.returning_list);
+			break;
+		}
+		case StatementType::DELETE_STATEMENT: {
+			auto &del = (const DeleteStatement &)stmt;
+			HashCTEs(del.cte_map);
+			HashOptionalTableRef(del.table.get());
+			for (auto &using_clause : del.using_clauses) {
+				HashOptionalTableRef(using_clause.get());
+			}
+			HashExpression(del.condition.get());
+			HashExpressions(del.returning_list);
+			break;
+		}
+		default:
+			// SET, PRAGMA, CREATE, ...: rare in query logs and not normalized
+			HashText(stmt.ToString());
+			break;
+		}
+	}
+
+	hash_t hash = 0;
+
+private:
+	// marks the start of a clause of a select node
+	enum class Clause : uint8_t { CTE, From, Select, Where, GroupBy, Having, Qualify, Modifier };
+
+	// what literals and parameters hash as
+	static constexpr hash_t PLACEHOLDER_HASH = 0x9e3779b97f4a7c15ULL;
+
+	void Combine(hash_t value) {
+		hash = CombineHash(hash, value);
+	}
+	void HashCount(idx_t count) {
+		Combine(duckdb::Hash<uint64_t>(count));
+	}
+	void HashClause(Clause clause) {
+		Combine(duckdb::Hash<uint8_t>(static_cast<uint8_t>(clause)));
+	}
+	void HashText(const string &text) {
+		Combine(duckdb::Hash(text.c_str(), text.size()));
+	}
+	void HashName(const string &name) {
+		// identifiers compare case-insensitively
+		Combine(StringUtil::CIHash(name));
+	}
+	void HashNames(const vector<string> &names) {
+		HashCount(names.size());
+		for (auto &name : names) {
+			HashName(name);
+		}
+	}
+
+	void HashCTEs(const CommonTableExpressionMap &cte_map) {
+		for (auto &entry : cte_map.map) {
+			HashClause(Clause::CTE);
+			HashName(entry.first);
+			if (entry.second) {
+				HashNames(entry.second->aliases);
+				Combine(duckdb::Hash<uint8_t>(static_cast<uint8_t>(entry.second->materialized)));
+			}
+			HashQueryNode(entry.second && entry.second->query ? entry.second->query->node.get() : nullptr);
+		}
+	}
+
+	void HashQueryNode(const QueryNode *node) {
+		if (!node) {
+			Combine(0);
+			return;
+		}
+		Combine(duckdb::Hash<uint8_t>(static_cast<uint8_t>(node->type)));
+		HashCTEs(node->cte_map);
+		switch (node->type) {
+		case QueryNodeType::SELECT_NODE: {
+			auto &select_node = (const SelectNode &)*node;
+			if (select_node.from_table) {
+				HashClause(Clause::From);
+				HashTableRef(*select_node.from_table);
+			}
+			HashClause(Clause::Select);
+			HashExpressions(select_node.select_list);
+			HashClause(Clause::Where);
+			HashExpression(select_node.where_clause.get());
+			HashClause(Clause::GroupBy);
+			HashExpressions(select_node.groups.group_expressions);
+			HashClause(Clause::Having);
+			HashExpression(select_node.having.get());
+			HashClause(Clause::Qualify);
+			HashExpression(select_node.qualify.get());
+			Combine(duckdb::Hash<uint8_t>(static_cast<uint8_t>(select_node.aggregate_handling)));
+			break;
+		}
+		case QueryNodeType::SET_OPERATION_NODE: {
+			auto &setop_node = (const SetOperationNode &)*node;
+			Combine(duckdb::Hash<uint8_t>(static_cast<uint8_t>(setop_node.setop_type)));
+			Combine(duckdb::Hash<bool>(setop_node.setop_all));
+			HashCount(setop_node.children.size());
+			for (auto &child : setop_node.children) {
+				HashQueryNode(child.get());
+			}
+			break;
+		}
+		case QueryNodeType::RECURSIVE_CTE_NODE: {
+			auto &cte_node = (const RecursiveCTENode &)*node;
+			HashName(cte_node.ctename);
+			Combine(duckdb::Hash<bool>(cte_node.union_all));
+			HashNames(cte_node.aliases);
+			HashExpressions(cte_node.key_targets);
+			HashQueryNode(cte_node.left.get());
+			HashQueryNode(cte_node.right.get());
+			break;
+		}
+		case QueryNodeType::CTE_NODE: {
+			auto &cte_node = (const CTENode &)*node;
+			HashName(cte_node.ctename);
+			HashQueryNode(cte_node.query.get());
+			HashQueryNode(cte_node.child.get());
+			break;
+		}
+		default:
+			break;
+		}
+		for (auto &modifier : node->modifiers) {
+			HashClause(Clause::Modifier);
+			HashModifier(*modifier);
+		}
+	}
+
+	void HashModifier(const ResultModifier &modifier) {
+		Combine(duckdb::Hash<uint8_t>(static_cast<uint8_t>(modifier.type)));
+		switch (modifier.type) {
+		case ResultModifierType::ORDER_MODIFIER: {
+			auto &order_modifier = (const OrderModifier &)modifier;
+			HashOrders(order_modifier.orders);
+			break;
+		}
+		case ResultModifierType::LIMIT_MODIFIER: {
+			auto &limit_modifier = (const LimitModifier &)modifier;
+			HashExpression(limit_modifier.limit.get());
+			HashExpression(limit_modifier.offset.get());
+			break;
+		}
+		case ResultModifierType::LIMIT_PERCENT_MODIFIER: {
+			auto &limit_modifier = (const LimitPercentModifier &)modifier;
+			HashExpression(limit_modifier.limit.get());
+			HashExpression(limit_modifier.offset.get());
+			break;
+		}
+		case ResultModifierType::DISTINCT_MODIFIER: {
+			auto &distinct_modifier = (const DistinctModifier &)modifier;
+			HashExpressions(distinct_modifier.distinct_on_targets);
+			break;
+		}
+		default:
+			break;
+		}
+	}
+
+	void HashOrders(const vector<OrderByNode> &orders) {
+		HashCount(orders.size());
+		for (auto &order : orders) {
+			Combine(duckdb::Hash<uint8_t>(static_cast<uint8_t>(order.type)));
+			Combine(duckdb::Hash<uint8_t>(static_cast<uint8_t>(order.null_order)));
+			HashExpression(order.expression.get());
+		}
+	}
+
+	void HashUpdateSetInfo(const UpdateSetInfo *set_info) {
+		if (!set_info) {
+			Combine(0);
+			return;
+		}
+		HashNames(set_info->columns);
+		HashExpressions(set_info->expressions);
+		HashExpression(set_info->condition.get());
+	}
+
+	void HashOptionalTableRef(const TableRef *ref) {
+		if (!ref) {
+			Combine(0);
+			return;
+		}
+		HashTableRef(*ref);
+	}
+
+	void HashTableRef(const TableRef &ref) {
+		Combine(duckdb::Hash<uint8_t>(static_cast<uint8_t>(ref.type)));
+		switch (ref.type) {
+		case TableReferenceType::BASE_TABLE: {
+			auto &base = (const BaseTableRef &)ref;
+			HashName(base.catalog_name);
+			HashName(base.schema_name);
+			HashName(base.table_name);
+			break;
+		}
+		case TableReferenceType::JOIN: {
+			auto &join = (const JoinRef &)ref;
+			Combine(duckdb::Hash<uint8_t>(static_cast<uint8_t>(join.type)));
+			Combine(duckdb::Hash<uint8_t>(static_cast<uint8_t>(join.ref_type)));
+			HashTableRef(*join.left);
+			HashTableRef(*join.right);
+			HashExpression(join.condition.get());
+			HashNames(join.using_columns);
+			break;
+		}
+		case TableReferenceType::SUBQUERY: {
+			auto &subquery = (const SubqueryRef &)ref;
+			HashQueryNode(subquery.subquery ? subquery.subquery->node.get() : nullptr);
+			break;
+		}
+		case TableReferenceType::TABLE_FUNCTION: {
+			auto &table_function = (const TableFunctionRef &)ref;
+			HashExpression(table_function.function.get());
+			break;
+		}
+		case TableReferenceType::EXPRESSION_LIST: {
+			auto &values = (const ExpressionListRef &)ref;
+			HashCount(values.values.size());
+			for (auto &row : values.values) {
+				HashExpressions(row);
+			}
+			break;
+		}
+		case TableReferenceType::PIVOT: {
+			auto &pivot = (const PivotRef &)ref;
+			HashOptionalTableRef(pivot.source.get());
+			HashExpressions(pivot.aggregates);
+			HashNames(pivot.unpivot_names);
+			HashNames(pivot.groups);
+			Combine(duckdb::Hash<bool>(pivot.include_nulls));
+			HashCount(pivot.pivots.size());
+			for (auto &column : pivot.pivots) {
+				HashExpressions(column.pivot_expressions);
+				HashNames(column.unpivot_names);
+				HashName(column.pivot_enum);
+				HashQueryNode(column.subquery.get());
+				// the IN list of a PIVOT names the output columns: its values are part of the shape
+				HashCount(column.entries.size());
+				for (auto &entry : column.entries) {
+					for (auto &value : entry.values) {
+						Combine(value.Hash());
+					}
+					HashExpression(entry.expr.get());
+					HashName(entry.alias);
+				}
+			}
+			break;
+		}
+		case TableReferenceType::SHOW_REF: {
+			auto &show = (const ShowRef &)ref;
+			Combine(duckdb::Hash<uint8_t>(static_cast<uint8_t>(show.show_type)));
+			HashName(show.table_name);
+			HashQueryNode(show.query.get());
+			break;
+		}
+		default:
+			// EMPTY_FROM, and the types the parser does not produce
+			break;
+		}
+	}
+
+	static bool IsLiteral(const ParsedExpression &expr) {
+		return expr.GetExpressionClass() == ExpressionClass::CONSTANT ||
+		       expr.GetExpressionClass() == ExpressionClass::PARAMETER;
+	}
+
+	void HashExpressions(const vector<unique_ptr<ParsedExpression>> &expressions) {
+		HashCount(expressions.size());
+		for (auto &expr : expressions) {
+			HashExpression(expr.get());
+		}
+	}
+
+	void HashExpression(const ParsedExpression *expr) {
+		if (!expr) {
+			Combine(0);
+			return;
+		}
+		if (IsLiteral(*expr)) {
+			Combine(PLACEHOLDER_HASH);
+			return;
+		}
+		Combine(duckdb::Hash<uint8_t>(static_cast<uint8_t>(expr->GetExpressionClass())));
+		Combine(duckdb::Hash<uint8_t>(static_cast<uint8_t>(expr->GetExpressionType())));
+		switch (expr->GetExpressionClass()) {
+		case ExpressionClass::COLUMN_REF: {
+			auto &column_ref = (const ColumnRefExpression &)*expr;
+			HashNames(column_ref.column_names);
+			return;
+		}
+		case ExpressionClass::FUNCTION: {
+			auto &function = (const FunctionExpression &)*expr;
+			HashName(function.catalog);
+			HashName(function.schema);
+			HashName(function.function_name);
+			Combine(duckdb::Hash<bool>(function.distinct));
+			Combine(duckdb::Hash<bool>(function.export_state));
+			HashExpressions(function.children);
+			HashExpression(function.filter.get());
+			if (function.order_bys) {
+				HashOrders(function.order_bys->orders);
+			} else {
+				Combine(0);
+			}
+			return;
+		}
+		case ExpressionClass::WINDOW: {
+			auto &window = (const WindowExpression &)*expr;
+			HashName(window.catalog);
+			HashName(window.schema);
+			HashName(window.function_name);
+			Combine(duckdb::Hash<bool>(window.ignore_nulls));
+			Combine(duckdb::Hash<bool>(window.distinct));
+			Combine(duckdb::Hash<uint8_t>(static_cast<uint8_t>(window.start)));
+			Combine(duckdb::Hash<uint8_t>(static_cast<uint8_t>(window.end)));
+			Combine(duckdb::Hash<uint8_t>(static_cast<uint8_t>(window.exclude_clause)));
+			HashExpressions(window.children);
+			HashExpressions(window.partitions);
+			HashOrders(window.orders);
+			HashOrders(window.arg_orders);
+			HashExpression(window.start_expr.get());
+			HashExpression(window.end_expr.get());
+			HashExpression(window.offset_expr.get());
+			HashExpression(window.default_expr.get());
+			HashExpression(window.filter_expr.get());
+			return;
+		}
+		case ExpressionClass::SUBQUERY: {
+			auto &subquery = (const SubqueryExpression &)*expr;
+			Combine(duckdb::Hash<uint8_t>(static_cast<uint8_t>(subquery.subquery_type)));
+			Combine(duckdb::Hash<uint8_t>(static_cast<uint8_t>(subquery.comparison_type)));
+			HashExpression(subquery.child.get());
+			HashQueryNode(subquery.subquery ? subquery.subquery->node.get() : nullptr);
+			return;
+		}
+		case ExpressionClass::OPERATOR: {
+			auto &op = (const OperatorExpression &)*expr;
+			if ((op.type == ExpressionType::COMPARE_IN || op.type == ExpressionType::COMPARE_NOT_IN) &&
+			    op.children.size() > 2) {
+				// x IN (1, 2, 3) has the shape of x IN (1)
+				bool all_literals = true;
+				for (idx_t i = 1; i < op.children.size(); i++) {
+					all_literals = all_literals && IsLiteral(*op.children[i]);
+				}
+				if (all_literals) {
+					HashCount(2);
+					HashExpression(op.children[0].get());
+					Combine(PLACEHOLDER_HASH);
+					return;
+				}
+			}
+			break;
+		}
+		case ExpressionClass::CAST: {
+			auto &cast = (const CastExpression &)*expr;
+			Combine(cast.cast_type.Hash());
+			Combine(duckdb::Hash<bool>(cast.try_cast));
+			break;
+		}
+		case ExpressionClass::COLLATE: {
+			auto &collate = (const CollateExpression &)*expr;
+			HashName(collate.collation);
+			break;
+		}
+		case ExpressionClass::STAR: {
+			auto &star = (const StarExpression &)*expr;
+			HashName(star.relation_name);
+			Combine(duckdb::Hash<bool>(star.columns));
+			Combine(duckdb::Hash<bool>(star.unpacked));
+			// the sets and maps of a star are unordered: sum their entries
+			hash_t names = 0;
+			for (auto &column : star.exclude_list) {
+				names += StringUtil::CIHash(column.column);
+			}
+			for (auto &entry : star.replace_list) {
+				names += StringUtil::CIHash(entry.first);
+			}
+			for (auto &entry : star.rename_list) {
+				names += CombineHash(StringUtil::CIHash(entry.first.column), StringUtil::CIHash(entry.second));
+			}
+			Combine(names);
+			break;
+		}
+		case ExpressionClass::POSITIONAL_REFERENCE: {
+			auto &reference = (const PositionalReferenceExpression &)*expr;
+			HashCount(reference.index);
+			return;
+		}
+		default:
+			break;
+		}
+		// conjunctions, comparisons, operators, CASE, BETWEEN, lambdas, ...: the shape is in the children
+		idx_t child_count = 0;
+		ParsedExpressionIterator::EnumerateChildren(*expr, [&](const ParsedExpression &child) {
+			HashExpression(&child);
+			child_count++;
+		});
+		HashCount(child_count);
+	}
+};
+
+} // namespace
+
+hash_t FingerprintStatements(const vector<unique_ptr<SQLStatement>> &statements) {
+	FingerprintHasher hasher;
+	for (auto &stmt : statements) {
+		if (stmt) {
+			hasher.HashStatement(*stmt);
+		}
+	}
+	return hasher.hash;
+}
+
+// Scalar functions
+// ---------------------------------------------------
+
+static void SQLFingerprintFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &parser = ParserToolsLocalState::Get(state).parser;
+	UnaryExecutor::ExecuteWithNulls<string_t, uint64_t>(
+	    args.data[0], result, args.size(), [&](string_t query, ValidityMask &mask, idx_t idx) -> uint64_t {
+		    auto parsed = parser.Parse(query);
+		    if (!parsed->success) {
+			    mask.SetInvalid(idx);
+			    return 0;
+		    }
+		    // hashed in place: the placeholders are only hashed, never created
+		    auto &counters = parser.Counters();
+		    StatsTimer timer(counters.walk_ns);
+		    counters.rows++;
+		    return FingerprintStatements(parsed->statements);
+	    });
+}
+
+// The parsed queries are shared through the parse cache and must not be modified: normalize a copy
+static vector<unique_ptr<SQLStatement>> CopyStatements(const ParsedQuery &parsed) {
+	vector<unique_ptr<SQLStatement>> statements;
+	for (auto &stmt : parsed.statements) {
+		if (stmt) {
+			statements.push_back(stmt->Copy());
+		}
+	}
+	return statements;
+}
+
+static void SQLNormalizeFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &parser = ParserToolsLocalState::Get(state).parser;
+	UnaryExecutor::ExecuteWithNulls<string_t, string_t>(
+	    args.data[0], result, args.size(), [&](string_t query, ValidityMask &mask, idx_t idx) -> string_t {
+		    auto parsed = parser.Parse(query);
+		    if (!parsed->success) {
+			    mask.SetInvalid(idx);
+			    return string_t("", 0);
+		    }
+		    auto &counters = parser.Counters();
+		    counters.rows++;
+		    vector<unique_ptr<SQLStatement>> statements;
+		    {
+			    StatsTimer timer(counters.walk_ns);
+			    statements = CopyStatements(*parsed);
+			    NormalizeStatements(statements);
+		    }
+		    StatsTimer timer(counters.materialize_ns);
+		    string normalized;
+		    for (auto &stmt : statements) {
+			    if (!normalized.empty()) {
+				    normalized += "; ";
+			    }
+			    normalized += stmt->ToString();
+		    }
+		    return StringVector::AddString(result, normalized);
+	    });
+}
+
+// Extension scaffolding
+// ---------------------------------------------------
+
+void RegisterSQLFingerprintScalarFunction(ExtensionLoader &loader) {
+	// sql_fingerprint returns a 64-bit hash of the query shape: queries differing only in their literals agree
+	auto fingerprint = ParserToolsScalarFunction("sql_fingerprint", {LogicalType::VARCHAR}, LogicalType::UBIGINT,
+	                                             SQLFingerprintFunction);
+	loader.RegisterFunction(fingerprint);
+
+	// sql_normalize returns the query with its literals replaced by placeholders: the tree sql_fingerprint hashes, as text
+	auto normalize = ParserToolsScalarFunction("sql_normalize", {LogicalType::VARCHAR}, LogicalType::VARCHAR,
+	                                           SQLNormalizeFunction);
+	loader.RegisterFunction(normalize);
+}
+
+} // namespace duckdb
@@ -0,0 +1,243 @@
+#include "sql_prefilter.hpp"
+#include "duckdb.hpp"
+
+namespace duckdb {
+
+static inline bool IsWordCharacter(unsigned char c) {
+	// bytes >= 0x80 are part of (UTF-8 encoded) identifiers
+	return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || c >= 0x80;
+}
+
+static inline bool IsAsciiWordCharacter(unsigned char c) {
+	return c < 0x80 && IsWordCharacter(c);
+}
+
+static inline bool IsSpace(unsigned char c) {
+	return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
+
+// Case-insensitive comparison of the word [sql + start, sql + end) with a lower case keyword
+static bool WordEquals(const char *sql, idx_t start, idx_t end, const char *keyword) {
+	idx_t i = 0;
+	for (; start + i < end; i++) {
+		auto c = static_cast<unsigned char>(sql[start + i]);
+		if (c >= 'A' && c <= 'Z') {
+			c |= 0x20;
+		}
+		if (keyword[i] == '\0' || c != static_cast<unsigned char>(keyword[i])) {
+			return false;
+		}
+	}
+	return keyword[i] == '\0';
+}
+
+static bool WordIsOneOf(const char *sql, idx_t start, idx_t end, const char *const *keywords) {
+	for (idx_t k = 0; keywords[k]; k++) {
+		if (WordEquals(sql, start, end, keywords[k])) {
+			return true;
+		}
+	}
+	return false;
+}
+
+// the leading keywords of statements that are transformed into a SelectStatement
+static const char *const SELECT_KEYWORDS[] = {"select", "with",  "from",        "values",       "table",
+                                              "pivot",  "unpivot", "pivot_wider", "pivot_longer", nullptr};
+// the words that may follow SELECT in a statement that contains nothing but constants
+static const char *const CONSTANT_KEYWORDS[] = {"null", "true", "false", nullptr};
+// the keywords that can introduce a table reference or a CTE
+static const char *const TABLE_KEYWORDS[] = {"from",        "table",        "with", "pivot", "unpivot",
+                                             "pivot_wider", "pivot_longer", nullptr};
+
+namespace {
+
+// Splits a query into tokens, only as far as needed for the prefilter: words, numbers, string literals and single
+// punctuation bytes. Comments and whitespace are skipped. `ok` is cleared for input the scanner does not
+// understand well enough (dollar quoting, escape strings), for which the prefilter has to give up.
+struct PrefilterScanner {
+	enum class TokenType : uint8_t { End, Word, Number, String, Punctuation };
+
+	PrefilterScanner(const char *sql_p, idx_t size_p) : sql(sql_p), size(size_p) {
+	}
+
+	TokenType Next() {
+		SkipSpaceAndComments();
+		start = pos;
+		if (pos >= size) {
+			return TokenType::End;
+		}
+		auto c = static_cast<unsigned char>(sql[pos]);
+		if (c == '\'' || c == '"') {
+			SkipQuoted(static_cast<char>(c));
+			// quoted identifiers are reported as words, which never match a keyword
+			return c == '\'' ? TokenType::String : TokenType::Word;
+		}
+		if (c == '$') {
+			// dollar-quoted strings and parameters
+			ok = false;
+			pos++;
+			return TokenType::Punctuation;
+		}
+		if (c >= '0' && c <= '9') {
+			while (pos < size && (IsWordCharacter(static_cast<unsigned char>(sql[pos])) || sql[pos] == '.')) {
+				if (static_cast<unsigned char>(sql[pos]) >= 0x80) {
+					// as in words: possibly a unicode space
+					ok = false;
+				}
+				pos++;
+			}
+			return TokenType::Number;
+		}
+		if (IsWordCharacter(c)) {
+			while (pos < size && IsWordCharacter(static_cast<unsigned char>(sql[pos]))) {
+				if (static_cast<unsigned char>(sql[pos]) >= 0x80) {
+					// possibly a unicode space, which the parser strips before parsing
+					ok = false;
+				}
+				pos++;
+			}
+			if (pos < size && sql[pos] == '\'') {
+				// E'...', X'...' and other prefixed string literals
+				ok = false;
+			}
+			return TokenType::Word;
+		}
+		pos++;
+		return TokenType::Punctuation;
+	}
+
+	bool IsWord(const char *keyword) const {
+		return WordEquals(sql, start, pos, keyword);
+	}
+	bool IsWordOneOf(const char *const *keywords) const {
+		return WordIsOneOf(sql, start, pos, keywords);
+	}
+	char Punctuation() const {
+		return sql[start];
+	}
+
+	const char *sql;
+	idx_t size;
+	idx_t pos = 0;
+	idx_t start = 0;
+	bool ok = true;
+
+private:
+	void SkipSpaceAndComments() {
+		while (pos < size) {
+			auto c = sql[pos];
+			if (IsSpace(static_cast<unsigned char>(c))) {
+				pos++;
+			} else if (c == '-' && pos + 1 < size && sql[pos + 1] == '-') {
+				while (pos < size && sql[pos] != '\n') {
+					pos++;
+				}
+			} else if (c == '/' && pos + 1 < size && sql[pos + 1] == '*') {
+				// block comments nest
+				idx_t depth = 0;
+				while (pos < size) {
+					if (sql[pos] == '/' && pos + 1 < size && sql[pos + 1] == '*') {
+						depth++;
+						pos += 2;
+					} else if (sql[pos] == '*' && pos + 1 < size && sql[pos + 1] == '/') {
+						depth--;
+						pos += 2;
+						if (depth == 0) {
+							break;
+						}
+					} else {
+						pos++;
+					}
+				}
+			} else {
+				break;
+			}
+		}
+	}
+
+	void SkipQuoted(char quote) {
+		pos++;
+		while (pos < size) {
+			if (sql[pos] == quote) {
+				if (pos + 1 < size && sql[pos + 1] == quote) {
+					// doubled quote
+					pos += 2;
+					continue;
+				}
+				pos++;
+				return;
+			}
+			pos++;
+		}
+	}
+};
+
+} // namespace
+
+bool SQLPrefilter::MayContainSelect(const char *sql, idx_t size) {
+	PrefilterScanner scanner(sql, size);
+	auto token = scanner.Next();
+	while (token != PrefilterScanner::TokenType::End) {
+		// the start of a statement: skip empty statements and opening parentheses
+		while (token == PrefilterScanner::TokenType::Punctuation &&
+		       (scanner.Punctuation() == ';' || scanner.Punctuation() == '(')) {
+			token = scanner.Next();
+		}
+		if (token == PrefilterScanner::TokenType::End) {
+			break;
+		}
+		bool select_statement = token == PrefilterScanner::TokenType::Word && scanner.IsWordOneOf(SELECT_KEYWORDS);
+		// SELECT followed by nothing but constants, such as the SELECT 1 heartbeats of connection pools
+		bool constant_select = select_statement && scanner.IsWord("select");
+
+		// the rest of the statement
+		token = scanner.Next();
+		while (token != PrefilterScanner::TokenType::End &&
+		       !(token == PrefilterScanner::TokenType::Punctuation && scanner.Punctuation() == ';')) {
+			if (constant_select) {
+				switch (token) {
+				case PrefilterScanner::TokenType::Number:
+				case PrefilterScanner::TokenType::String:
+					break;
+				case PrefilterScanner::TokenType::Word:
+					constant_select = scanner.IsWordOneOf(CONSTANT_KEYWORDS);
+					break;
+				default:
+					constant_select = scanner.Punctuation() == ',';
+					break;
+				}
+			}
+			token = scanner.Next();
+		}
+		if (!scanner.ok) {
+			return true;
+		}
+		if (select_statement && !constant_select) {
+			return true;
+		}
+	}
+	return !scanner.ok;
+}
+
+bool SQLPrefilter::MayContainTableKeyword(const char *sql, idx_t size) {
+	// a plain pass over the bytes, looking at word starts only: keywords inside string literals or comments
+	// make the check more conservative, never wrong. Non-ASCII bytes separate words, as they may be unicode spaces
+	idx_t i = 0;
+	while (i < size) {
+		auto c = static_cast<unsigned char>(sql[i]);
+		if (!IsAsciiWordCharacter(c)) {
+			i++;
+			continue;
+		}
+		auto start = i;
+		while (i < size && IsAsciiWordCharacter(static_cast<unsigned char>(sql[i]))) {
+			i++;
+		}
+		if (WordIsOneOf(sql, start, i, TABLE_KEYWORDS)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+} // namespace duckdb
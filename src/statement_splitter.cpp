@@ -0,0 +1,140 @@
+#include "statement_splitter.hpp"
+#include "duckdb.hpp"
+#include "duckdb/common/string_util.hpp"
+
+namespace duckdb {
+
+static inline bool IsIdentifierStart(unsigned char c) {
+	return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' || c >= 0x80;
+}
+
+static inline bool IsIdentifierCharacter(unsigned char c) {
+	return IsIdentifierStart(c) || (c >= '0' && c <= '9') || c == '$';
+}
+
+// Returns the position just past the quoted text starting at `pos` (the opening quote)
+static idx_t SkipQuoted(const char *sql, idx_t size, idx_t pos, char quote, bool backslash_escapes) {
+	pos++;
+	while (pos < size) {
+		auto c = sql[pos];
+		if (backslash_escapes && c == '\\') {
+			pos += 2;
+			continue;
+		}
+		if (c == quote) {
+			if (pos + 1 < size && sql[pos + 1] == quote) {
+				// doubled quote
+				pos += 2;
+				continue;
+			}
+			return pos + 1;
+		}
+		pos++;
+	}
+	return size;
+}
+
+// If a dollar quote ($$ or $tag$) starts at `pos`, returns the position just past its closing delimiter
+static bool TrySkipDollarQuoted(const char *sql, idx_t size, idx_t pos, idx_t &end) {
+	idx_t tag_end = pos + 1;
+	if (tag_end < size && IsIdentifierStart(static_cast<unsigned char>(sql[tag_end]))) {
+		while (tag_end < size && IsIdentifierCharacter(static_cast<unsigned char>(sql[tag_end])) &&
+		       sql[tag_end] != '$') {
+			tag_end++;
+		}
+	}
+	if (tag_end >= size || sql[tag_end] != '$') {
+		// not a dollar quote, e.g. a $1 parameter
+		return false;
+	}
+	auto tag_size = tag_end + 1 - pos;
+	for (idx_t i = tag_end + 1; i + tag_size <= size; i++) {
+		if (sql[i] == '$' && memcmp(sql + i, sql + pos, tag_size) == 0) {
+			end = i + tag_size;
+			return true;
+		}
+	}
+	end = size;
+	return true;
+}
+
+vector<idx_t> SplitStatements(const char *sql, idx_t size) {
+	vector<idx_t> ends;
+	idx_t pos = 0;
+	bool statement_has_text = false;
+	while (pos < size) {
+		auto c = sql[pos];
+		auto previous = pos > 0 ? static_cast<unsigned char>(sql[pos - 1]) : '\0';
+		switch (c) {
+		case ';':
+			pos++;
+			ends.push_back(pos);
+			statement_has_text = false;
+			continue;
+		case '\'': {
+			// E'...' strings support backslash escapes
+			bool escape_string = (previous == 'e' || previous == 'E') &&
+			                     (pos < 2 || !IsIdentifierCharacter(static_cast<unsigned char>(sql[pos - 2])));
+			pos = SkipQuoted(sql, size, pos, '\'', escape_string);
+			break;
+		}
+		case '"':
+			pos = SkipQuoted(sql, size, pos, '"', false);
+			break;
+		case '-':
+			if (pos + 1 < size && sql[pos + 1] == '-') {
+				while (pos < size && sql[pos] != '\n') {
+					pos++;
+				}
+				continue;
+			}
+			pos++;
+			break;
+		case '/':
+			if (pos + 1 < size && sql[pos + 1] == '*') {
+				// block comments nest
+				idx_t depth = 0;
+				while (pos < size) {
+					if (sql[pos] == '/' && pos + 1 < size && sql[pos + 1] == '*') {
+						depth++;
+						pos += 2;
+					} else if (sql[pos] == '*' && pos + 1 < size && sql[pos + 1] == '/') {
+						depth--;
+						pos += 2;
+						if (depth == 0) {
+							break;
+						}
+					} else {
+						pos++;
+					}
+				}
+				continue;
+			}
+			pos++;
+			break;
+		case '$': {
+			idx_t end;
+			// a $ inside an identifier does not start a dollar quote
+			if (!IsIdentifierCharacter(previous) && TrySkipDollarQuoted(sql, size, pos, end)) {
+				pos = end;
+			} else {
+				pos++;
+			}
+			break;
+		}
+		default:
+			pos++;
+			if (StringUtil::CharacterIsSpace(c)) {
+				continue;
+			}
+			break;
+		}
+		statement_has_text = true;
+	}
+	if (statement_has_text) {
+		ends.push_back(size);
+	}
+	return ends;
+}
+
+} // namespace duckdb
@@ -0,0 +1,206 @@
+#include "usage_aggregates.hpp"
+#include "ast_collectors.hpp"
+#include "parse_cache.hpp"
+#include "duckdb.hpp"
+#include "duckdb/function/aggregate_function.hpp"
+#include <algorithm>
+
+namespace duckdb {
+
+// table_usage(sql) / function_usage(sql) count how often each table or function name occurs in a column of
+// queries. The names go straight into a per-group hash map, so the aggregation runs in parallel (with combine)
+// and no LIST is materialized per row as with unnest(parse_table_names(sql)).
+
+struct UsageState {
+	// allocated on the first non-NULL query, so that groups without any query finalize to NULL
+	unordered_map<string, idx_t> *counts;
+};
+
+struct UsageBindData : public FunctionData {
+	UsageBindData(string function_name_p, ParserSettings settings_p)
+	    : function_name(std::move(function_name_p)), settings(std::move(settings_p)) {
+	}
+
+	string function_name;
+	// aggregates have no client context at execution time: the parser settings are resolved here
+	ParserSettings settings;
+
+	unique_ptr<FunctionData> Copy() const override {
+		return make_uniq<UsageBindData>(function_name, settings);
+	}
+	bool Equals(const FunctionData &other_p) const override {
+		auto &other = other_p.Cast<UsageBindData>();
+		return settings.cache == other.settings.cache && settings.capacity == other.settings.capacity &&
+		       settings.prefilter == other.settings.prefilter;
+	}
+};
+
+// The names table_usage counts; CTE definitions and references are not tables, as in parse_table_names
+struct TableUsage {
+	static constexpr ParseTarget TARGET = ParseTarget::Tables;
+
+	template <class ADD>
+	static void Extract(const ParsedQuery &parsed, ADD &&add) {
+		std::vector<TableRefResult> tables;
+		ExtractTablesFromStatements(parsed.statements, tables, NON_CTE_CONTEXTS);
+		for (auto &table : tables) {
+			add(table.table);
+		}
+	}
+};
+
+struct FunctionUsage {
+	static constexpr ParseTarget TARGET = ParseTarget::Functions;
+
+	template <class ADD>
+	static void Extract(const ParsedQuery &parsed, ADD &&add) {
+		std::vector<FunctionResult> functions;
+		FunctionCollector collector(functions);
+		WalkStatements(parsed.statements, collector);
+		for (auto &function : functions) {
+			add(function.function_name);
+		}
+	}
+};
+
+struct UsageOperation {
+	template <class STATE>
+	static void Initialize(STATE &state) {
+		state.counts = nullptr;
+	}
+
+	template <class STATE>
+	static void Destroy(STATE &state, AggregateInputData &aggr_input_data) {
+		delete state.counts;
+		state.counts = nullptr;
+	}
+};
+
+template <class USAGE>
+static void UsageUpdate(Vector inputs[], AggregateInputData &aggr_input_data, idx_t input_count, Vector &state_vector,
+                        idx_t count) {
+	auto &bind_data = aggr_input_data.bind_data->Cast<UsageBindData>();
+	// one parser per input vector, as the update may run on any thread
+	CachedParser parser(bind_data.settings, bind_data.function_name);
+	auto &counters = parser.Counters();
+
+	UnifiedVectorFormat sql_format;
+	inputs[0].ToUnifiedFormat(count, sql_format);
+	auto sql_data = UnifiedVectorFormat::GetData<string_t>(sql_format);
+	UnifiedVectorFormat state_format;
+	state_vector.ToUnifiedFormat(count, state_format);
+	auto states = UnifiedVectorFormat::GetData<UsageState *>(state_format);
+
+	for (idx_t i = 0; i < count; i++) {
+		auto idx = sql_format.sel->get_index(i);
+		if (!sql_format.validity.RowIsValid(idx)) {
+			continue;
+		}
+		auto &state = *states[state_format.sel->get_index(i)];
+		if (!state.counts) {
+			state.counts = new unordered_map<string, idx_t>();
+		}
+		auto &counts = *state.counts;
+		auto parsed = parser.Parse(sql_data[idx], USAGE::TARGET);
+		StatsTimer timer(counters.walk_ns);
+		USAGE::Extract(*parsed, [&](const string_t &name) {
+			counts[name.GetString()]++;
+			counters.rows++;
+		});
+	}
+}
+
+static void UsageCombine(Vector &source_vector, Vector &target_vector, AggregateInputData &aggr_input_data,
+                         idx_t count) {
+	UnifiedVectorFormat source_format;
+	source_vector.ToUnifiedFormat(count, source_format);
+	auto sources = UnifiedVectorFormat::GetData<UsageState *>(source_format);
+	auto targets = FlatVector::GetData<UsageState *>(target_vector);
+
+	for (idx_t i = 0; i < count; i++) {
+		auto &source = *sources[source_format.sel->get_index(i)];
+		if (!source.counts) {
+			continue;
+		}
+		auto &target = *targets[i];
+		if (!target.counts) {
+			target.counts = new unordered_map<string, idx_t>(*source.counts);
+			continue;
+		}
+		for (auto &entry : *source.counts) {
+			(*target.counts)[entry.first] += entry.second;
+		}
+	}
+}
+
+static void UsageFinalize(Vector &state_vector, AggregateInputData &aggr_input_data, Vector &result, idx_t count,
+                          idx_t offset) {
+	UnifiedVectorFormat state_format;
+	state_vector.ToUnifiedFormat(count, state_format);
+	auto states = UnifiedVectorFormat::GetData<UsageState *>(state_format);
+
+	auto &mask = FlatVector::Validity(result);
+	auto list_entries = FlatVector::GetData<list_entry_t>(result);
+	auto &child = ListVector::GetEntry(result);
+
+	vector<std::pair<string, idx_t>> entries;
+	for (idx_t i = 0; i < count; i++) {
+		auto &state = *states[state_format.sel->get_index(i)];
+		auto rid = i + offset;
+		if (!state.counts) {
+			mask.SetInvalid(rid);
+			continue;
+		}
+		// most used first, ties by name, so that the result does not depend on the hash map or the thread count
+		entries.assign(state.counts->begin(), state.counts->end());
+		std::sort(entries.begin(), entries.end(),
+		          [](const std::pair<string, idx_t> &a, const std::pair<string, idx_t> &b) {
+			          return a.second != b.second ? a.second > b.second : a.first < b.first;
+		          });
+
+		auto list_offset = ListVector::GetListSize(result);
+		auto new_size = list_offset + entries.size();
+		ListVector::Reserve(result, new_size);
+		auto &struct_entries = StructVector::GetEntries(child);
+		auto &name_vector = *struct_entries[0];
+		auto &count_vector = *struct_entries[1];
+		auto name_data = FlatVector::GetData<string_t>(name_vector);
+		auto count_data = FlatVector::GetData<uint64_t>(count_vector);
+		for (idx_t j = 0; j < entries.size(); j++) {
+			name_data[list_offset + j] = StringVector::AddString(name_vector, entries[j].first);
+			count_data[list_offset + j] = entries[j].second;
+		}
+		ListVector::SetListSize(result, new_size);
+		list_entries[rid] = list_entry_t(list_offset, entries.size());
+	}
+}
+
+static unique_ptr<FunctionData> UsageBind(ClientContext &context, AggregateFunction &function,
+                                          vector<unique_ptr<Expression>> &arguments) {
+	return make_uniq<UsageBindData>(function.name, ParserSettings::Get(context, context.GetParserOptions()));
+}
+
+template <class USAGE>
+static AggregateFunction UsageAggregateFunction(const string &name) {
+	auto return_type =
+	    LogicalType::LIST(LogicalType::STRUCT({{"name", LogicalType::VARCHAR}, {"count", LogicalType::UBIGINT}}));
+	AggregateFunction function(name, {LogicalType::VARCHAR}, return_type, AggregateFunction::StateSize<UsageState>,
+	                           AggregateFunction::StateInitialize<UsageState, UsageOperation>, UsageUpdate<USAGE>,
+	                           UsageCombine, UsageFinalize);
+	function.bind = UsageBind;
+	function.destructor = AggregateFunction::StateDestroy<UsageState, UsageOperation>;
+	function.order_dependent = AggregateOrderDependent::NOT_ORDER_DEPENDENT;
+	return function;
+}
+
+// Extension scaffolding
+// ---------------------------------------------------
+
+void RegisterUsageAggregateFunctions(ExtensionLoader &loader) {
+	// table_usage(sql) returns [{name, count}, ...] for the tables read by the queries, most used first
+	loader.RegisterFunction(UsageAggregateFunction<TableUsage>("table_usage"));
+	// function_usage(sql) does the same for the function calls
+	loader.RegisterFunction(UsageAggregateFunction<FunctionUsage>("function_usage"));
+}
+
+} // namespace duckdb